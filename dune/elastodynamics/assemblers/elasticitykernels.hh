@@ -0,0 +1,110 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef ELASTICITY_KERNELS_HH
+#define ELASTICITY_KERNELS_HH
+
+#include <cmath>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/elastodynamics/assemblers/hooketensor.hh>
+#include <dune/elastodynamics/assemblers/symmetrictensor.hh>
+
+namespace Dune::Elastodynamics {
+
+  // Stress kernels for the StiffnessAssembler, all with stress(strain, stress) on
+  // SymmetricTensor (tensor shear components, like the HookeTensor).
+
+  // isotropic material in Lamé form, sigma = lambda tr(e) I + 2 mu e, no matrix
+  // product; plane stress uses lambda* = 2 lambda mu / (lambda + 2 mu)
+  template <int dim>
+  class IsotropicMaterial {
+
+    private:
+
+      double lambda_, mu_;
+
+    public:
+
+      IsotropicMaterial(double E, double nu, PlaneAssumption assumption = PlaneAssumption::strain)
+        : lambda_(E*nu/((1.0+nu)*(1.0-2.0*nu))),
+          mu_(0.5*E/(1.0+nu))
+      {
+        if(dim == 2 and assumption == PlaneAssumption::stress)
+          lambda_ = 2.0*lambda_*mu_/(lambda_+2.0*mu_);
+      }
+
+      void stress(const SymmetricTensor<dim>& strain, SymmetricTensor<dim>& stress) const {
+        stress = strain;
+        stress *= 2.0*mu_;
+        stress.addToDiag(lambda_*strain.trace());
+      }
+
+      double lambda() const { return lambda_; }
+      double mu() const { return mu_; }
+  };
+
+  // general anisotropic material, only the nonzero entries of the Voigt matrix C
+  // are kept, e.g. 12 of 36 for an orthotropic material in its principal axes
+  template <int dim>
+  class SparseHookeTensor {
+
+    public:
+
+      static const int size = (dim+1)*dim/2;
+
+    private:
+
+      struct Entry {
+        int row, col;
+        double value;
+      };
+
+      std::vector<Entry> entries_;
+
+    public:
+
+      SparseHookeTensor(const Dune::FieldMatrix<double, size, size>& C) {
+        for(int i=0; i<size; i++)
+          for(int j=0; j<size; j++)
+            if(C[i][j] != 0.0)
+              entries_.push_back({i, j, C[i][j]});
+      }
+
+      void stress(const SymmetricTensor<dim>& strain, SymmetricTensor<dim>& stress) const {
+        stress = 0.0;
+        for(const auto& entry : entries_)
+          stress[entry.row] += entry.value*strain[entry.col];
+      }
+
+      std::size_t nonZeros() const { return entries_.size(); }
+  };
+
+  // Voigt matrix of an orthotropic material in its principal axes,
+  // E = (E1, E2, E3), nu = (nu12, nu13, nu23), G = (G12, G13, G23)
+  inline Dune::FieldMatrix<double, 6, 6> orthotropicHookeTensor(const Dune::FieldVector<double, 3>& E,
+                                                                const Dune::FieldVector<double, 3>& nu,
+                                                                const Dune::FieldVector<double, 3>& G)
+  {
+    // normal part: inverse of the compliance
+    Dune::FieldMatrix<double, 3, 3> S = {{1.0/E[0],     -nu[0]/E[0],  -nu[1]/E[0]},
+                                         {-nu[0]/E[0],  1.0/E[1],     -nu[2]/E[1]},
+                                         {-nu[1]/E[0],  -nu[2]/E[1],  1.0/E[2]}};
+    S.invert();
+
+    Dune::FieldMatrix<double, 6, 6> C(0.0);
+    for(int i=0; i<3; i++)
+      for(int j=0; j<3; j++)
+        C[i][j] = S[i][j];
+
+    // shear in tensor components, sigma_ij = 2 G_ij e_ij
+    for(int k=0; k<3; k++)
+      C[3+k][3+k] = 2.0*G[k];
+
+    return C;
+  }
+}
+
+#endif
@@ -15,6 +15,9 @@ Availability: https://git.imp.fu-berlin.de/agnumpde/dune-fufem/-/blob/master/dun
 
 namespace Dune::Elastodynamics {
 
+  // two-dimensional models: plane strain (thick parts) or plane stress (thin plates)
+  enum class PlaneAssumption { strain, stress };
+
   template <int dim>
   class HookeTensor {
   
@@ -33,26 +36,29 @@ namespace Dune::Elastodynamics {
     
       Dune::FieldMatrix<double, (dim+1)*dim/2, (dim+1)*dim/2> C = 0.0;
     
-      HookeTensor(double E, double nu) {
-        
-        // Here be careful which to choose, i guess      
-        // plane strain
-        C[0][0] = 1.0-nu; C[0][1] = nu;
-        C[1][0] = nu;     C[1][1] = 1.0-nu;
+      HookeTensor(double E, double nu, PlaneAssumption assumption = PlaneAssumption::strain) {
         
-        C[2][2] = 1.0-2.0*nu;
+        if(assumption == PlaneAssumption::strain) {
+          C[0][0] = 1.0-nu; C[0][1] = nu;
+          C[1][0] = nu;     C[1][1] = 1.0-nu;
         
-        C *= E/((1.0+nu)*(1.0-2.0*nu));
+          C[2][2] = 1.0-2.0*nu;
         
-        // plane stress
-        /*
-        C[0][0] = 1.0; C[0][1] = nu;
-        C[1][0] = nu;  C[1][1] = 1.0;
+          C *= E/((1.0+nu)*(1.0-2.0*nu));
+        }
+        else {
+          C[0][0] = 1.0; C[0][1] = nu;
+          C[1][0] = nu;  C[1][1] = 1.0;
         
-        C[2][2] = 1.0-nu;
+          C[2][2] = 1.0-nu;
         
-        C *= E/(1.0-nu*nu);
-        */
+          C *= E/(1.0-nu*nu);
+        }
+      }
+
+      template <class Strain>
+      void stress(const Strain& strain, Strain& stress) const {
+        C.mv(strain, stress);
       }
   };
      
@@ -66,7 +72,8 @@ namespace Dune::Elastodynamics {
     
       Dune::FieldMatrix<double, (dim+1)*dim/2, (dim+1)*dim/2> C = 0.0;
     
-      HookeTensor<3>(double E, double nu) {
+      // the plane assumption has no meaning in 3D, kept for a uniform interface
+      HookeTensor(double E, double nu, PlaneAssumption = PlaneAssumption::strain) {
       
         C[0][0] = 1.0-nu; C[0][1] = nu;     C[0][2] = nu;
         C[1][0] = nu;     C[1][1] = 1.0-nu; C[1][2] = nu;
@@ -79,6 +86,11 @@ namespace Dune::Elastodynamics {
         C *= E/((1.0+nu)*(1.0-2.0*nu));
       
       }
+
+      template <class Strain>
+      void stress(const Strain& strain, Strain& stress) const {
+        C.mv(strain, stress);
+      }
   };
 }
 
@@ -4,11 +4,20 @@
 #ifndef LOBATTO_LUMPED_MASS_ASSEMBLER_HH
 #define LOBATTO_LUMPED_MASS_ASSEMBLER_HH
 
+#include <cmath>
+
+#include <dune/common/exceptions.hh>
 #include <dune/geometry/quadraturerules.hh>
 #include <dune/elastodynamics/quadraturerules/lumpingquadrature.hh>
 
 namespace Dune::Elastodynamics {
 
+  // Mass matrix integrated with the nodal lumping rule of the element, it is
+  // diagonal when the quadrature points are the nodes of the basis: vertices for
+  // p = 1, Gauss-Lobatto points on cubes for p = 2 and for GLL node bases. An
+  // equidistant Lagrange basis of order p > 2 would lose its coupling terms in a
+  // diagonal matrix and is rejected, the SpectralElementOperator has the
+  // diagonal mass on the GLL nodes for these orders.
   class LobattoLumpedMassAssembler {
 
     private:
@@ -34,18 +43,29 @@ namespace Dune::Elastodynamics {
         
         // this is cheating, but hey, it's the same in each dimension ;)
         const auto& localFE = localView.tree().child(0).finiteElement();
-        LumpingQuadratureRule<double, dim> quadRule(element.type());
+        const auto& quadRule = LumpingQuadratureRules<double, dim>::rule(element.type(), localFE.localBasis().order());
   
         localMatrix.setSize(localView.size(), localView.size());
         localMatrix = 0.0;
+        std::vector<FieldVector<double, 1>> shapefunctionValues(localFE.size());
              
         for(const auto& quadPoint : quadRule) {
     
           const auto quadPos = quadPoint.position();
           const double integrationElement = geometry.integrationElement(quadPos);
           
-          std::vector<FieldVector<double, 1>> shapefunctionValues(localFE.size());
           localFE.localBasis().evaluateFunction(quadPos, shapefunctionValues);
+
+          if(localFE.localBasis().order() > 2) {
+            std::size_t ones = 0, zeros = 0;
+            for(const auto& value : shapefunctionValues) {
+              ones += std::abs(value[0]-1.0) < 1e-10;
+              zeros += std::abs(value[0]) < 1e-10;
+            }
+            if(ones != 1 or zeros+1 != localFE.size())
+              DUNE_THROW(Dune::NotImplemented, "lumping of order " << localFE.localBasis().order()
+                         << " needs a basis with nodes at the Gauss-Lobatto points");
+          }
           
           for( int i=0; i<localFE.size(); i++) {
             for( int j=0; j<localFE.size(); j++) {
@@ -0,0 +1,61 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef MATERIAL_ASSEMBLERS_HH
+#define MATERIAL_ASSEMBLERS_HH
+
+#include <dune/elastodynamics/assemblers/consistentmassassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+
+namespace Dune::Elastodynamics {
+
+  // stiffness with the cached stress kernel of the element's material
+  template<class Table>
+  class MaterialStiffnessAssembler {
+
+    private:
+
+      const Table& table_;
+      StiffnessAssembler stiffness_;
+
+    public:
+
+      typedef typename StiffnessAssembler::LocalMatrix LocalMatrix;
+
+      MaterialStiffnessAssembler(const Table& table)
+        : table_(table), stiffness_(0.0, 0.0)
+      {}
+
+      template <class LocalView>
+      void assemble(LocalMatrix& localMatrix, LocalView& localView) {
+        stiffness_.assemble(localMatrix, localView, table_.tensor(localView.element()));
+      }
+  };
+
+  // any of the mass assemblers (consistent, HRZ, Lobatto) with unit density,
+  // scaled by the density of the element's material
+  template<class Table, class MassAssembler = ConsistentMassAssembler>
+  class MaterialMassAssembler {
+
+    private:
+
+      const Table& table_;
+      MassAssembler mass_;
+
+    public:
+
+      typedef typename MassAssembler::LocalMatrix LocalMatrix;
+
+      MaterialMassAssembler(const Table& table)
+        : table_(table), mass_(1.0)
+      {}
+
+      template <class LocalView>
+      void assemble(LocalMatrix& localMatrix, LocalView& localView) {
+        mass_.assemble(localMatrix, localView);
+        localMatrix *= table_.density(localView.element());
+      }
+  };
+}
+
+#endif
@@ -0,0 +1,97 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef MATERIAL_TABLE_HH
+#define MATERIAL_TABLE_HH
+
+#include <map>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/grid/common/mcmgmapper.hh>
+#include <dune/elastodynamics/assemblers/elasticitykernels.hh>
+
+namespace Dune::Elastodynamics {
+
+  struct Material {
+    double E, nu, rho;
+  };
+
+  // Element-to-material table from the physical groups of a Gmsh mesh (the
+  // materialIndex of the GmshReader). It is built once, the stress kernel of each
+  // material is constructed once and looked up per element by the material
+  // assemblers. Refined elements take the group of their macro element. The
+  // insertion indices are only known on the rank that read the grid, so the table
+  // has to be built before load balancing.
+  template<class GridView>
+  class MaterialTable {
+
+    public:
+
+      static const int dim = GridView::dimension;
+
+    private:
+
+      MultipleCodimMultipleGeomTypeMapper<GridView> mapper_;
+      std::vector<int> elementMaterial_;
+      std::vector<Material> materials_;
+      std::vector<IsotropicMaterial<dim>> tensors_;
+      PlaneAssumption assumption_;
+
+    public:
+
+      template<class GridFactory>
+      MaterialTable(const GridView& gridView, const GridFactory& factory,
+                    const std::vector<int>& materialIndex,
+                    const std::map<int, Material>& materials,
+                    PlaneAssumption assumption = PlaneAssumption::strain)
+        : mapper_(gridView, mcmgElementLayout())
+        , assumption_(assumption)
+      {
+        std::map<int, int> slot;
+        for( const auto& entry : materials) {
+          slot[entry.first] = materials_.size();
+          materials_.push_back(entry.second);
+          tensors_.emplace_back(entry.second.E, entry.second.nu, assumption);
+        }
+
+        elementMaterial_.resize(mapper_.size());
+        for( const auto& element : elements(gridView)) {
+          auto macro = element;
+          while(macro.hasFather())
+            macro = macro.father();
+
+          const int group = materialIndex[factory.insertionIndex(macro)];
+          auto it = slot.find(group);
+          if(it == slot.end())
+            DUNE_THROW(RangeError, "no material given for physical group " << group);
+          elementMaterial_[mapper_.index(element)] = it->second;
+        }
+      }
+
+      template<class Element>
+      const Material& material(const Element& element) const
+      {
+        return materials_[elementMaterial_[mapper_.index(element)]];
+      }
+
+      template<class Element>
+      const IsotropicMaterial<dim>& tensor(const Element& element) const
+      {
+        return tensors_[elementMaterial_[mapper_.index(element)]];
+      }
+
+      PlaneAssumption assumption() const
+      {
+        return assumption_;
+      }
+
+      template<class Element>
+      double density(const Element& element) const
+      {
+        return material(element).rho;
+      }
+  };
+}
+
+#endif
@@ -4,13 +4,19 @@
 #ifndef OPERATOR_ASSEMBLER_HH
 #define OPERATOR_ASSEMBLER_HH
 
+#include <type_traits>
+
+#include <dune/grid/common/partitionset.hh>
 #include <dune/istl/matrixindexset.hh>
 
 #include <omp.h>
 
 namespace Dune::Elastodynamics {
 
-  template <class Basis>
+  // PartitionSet selects the assembled elements: all (default) or interior for
+  // distributed grids, where every element then contributes on exactly one rank
+  // and the local matrices are additive (see parallel/README.md)
+  template <class Basis, class PartitionSet = Dune::Partitions::All>
   class OperatorAssembler {
   
     private:
@@ -22,7 +28,7 @@ namespace Dune::Elastodynamics {
 	    auto gridView  = basis_.gridView();
         auto localView = basis_.localView();
 			  
-        for( const auto& element : elements(gridView, Dune::Partitions::all)) {	
+        for( const auto& element : elements(gridView, PartitionSet{})) {	
   				
   	      localView.bind(element);
    					
@@ -44,7 +50,7 @@ namespace Dune::Elastodynamics {
         typedef typename LocalAssemblerType::LocalMatrix LocalMatrix;
         
         // here we could technically parallelize
-        for( const auto& element : elements(gridView, Dune::Partitions::all)) {
+        for( const auto& element : elements(gridView, PartitionSet{})) {
           
           auto localView = basis_.localView();
           localView.bind(element);
@@ -78,6 +84,10 @@ namespace Dune::Elastodynamics {
       {     
         Dune::MatrixIndexSet occupationPattern(basis_.size(), basis_.size());
 		addIndices(occupationPattern);
+		// dofs only touched by ghost elements keep a diagonal entry
+		if constexpr (!std::is_same_v<PartitionSet, Dune::Partitions::All>)
+		  for( size_t i=0; i<basis_.size(); i++)
+		    occupationPattern.add(i, i);
 		occupationPattern.exportIdx(A);
       }
 
@@ -86,9 +96,19 @@ namespace Dune::Elastodynamics {
 	  {			
 		A = 0.0;
 		addEntries(localAssembler, A, lumping);
+
+		// ... and get an identity row, they are decoupled and not owned
+		if constexpr (!std::is_same_v<PartitionSet, Dune::Partitions::All>)
+		  for( size_t i=0; i<A.N(); i++)
+		    if(A[i][i].frobenius_norm2() == 0.0)
+		      for( size_t k=0; k<A[i][i].N(); k++)
+		        A[i][i][k][k] = 1.0;
 	  }
 
   };
+
+  template <class Basis>
+  using DistributedOperatorAssembler = OperatorAssembler<Basis, Dune::Partitions::Interior>;
 }
 
 #endif
@@ -0,0 +1,333 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef SPECTRAL_ELEMENT_OPERATOR_HH
+#define SPECTRAL_ELEMENT_OPERATOR_HH
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/elastodynamics/assemblers/elasticitykernels.hh>
+#include <dune/elastodynamics/quadraturerules/gausslobattoquadrature.hh>
+
+namespace Dune::Elastodynamics {
+
+  // Spectral elements for power<dim>(lagrange<p>()) on cube grids: GLL quadrature
+  // on the (p+1)^dim Gauss-Lobatto-Legendre points. The coefficients are the
+  // values at the GLL points, the dofs of lagrange<p> are reused for them: the
+  // dof of the k-th equidistant node of a vertex, edge or face is the k-th GLL
+  // node there (both node sets are symmetric, so neighbours agree). For p <= 2
+  // both node sets coincide and the coefficients are the lagrange<p> ones, for
+  // p > 2 the dof transform T (GLL values to lagrange<p> coefficients, the same
+  // polynomial space) connects them to the other assemblers:
+  //   interpolate(x, f)              GLL nodal values, e.g. the node positions
+  //                                  for boundary conditions and point loads
+  //   lagrangeCoefficients(x, y)     y = T x, for output with the lagrange<p> basis
+  //   nodalLoads(b, y)               y = T^T b, loads assembled with lagrange<p>
+  //                                  (TractionAssembler, PatchLoad)
+  // The boundary dofs (BoundaryDofs) are topological and hold for both.
+  //
+  // The mass matrix is diagonal, lumpedMass() is the LobattoLumpedMassAssembler
+  // matrix for p <= 2. The stiffness is never assembled, mv/umv/mmv apply the
+  // StiffnessAssembler matrix with QuadratureType::GaussLobatto (transformed with
+  // T for p > 2) element by element with sum factorization: the reference
+  // gradients are 1D derivative matrices applied along each direction,
+  // O(p^(dim+1)) per element instead of O(p^(2 dim)). Isotropic material in
+  // Lamé form (plane strain or stress in 2D).
+  // Constrained rows are identity rows, as after the row-wise Dirichlet
+  // elimination, so the operator replaces the stiffness matrix in the
+  // RungeKuttaNystroem steppers.
+  template<class Basis>
+  class SpectralElementOperator {
+
+    public:
+
+      using GridView = typename Basis::GridView;
+      static const int dim = GridView::dimension;
+      using Jacobian = FieldMatrix<double, dim, dim>;
+      using Coordinate = FieldVector<double, dim>;
+
+    private:
+
+      int n_, nodes_;
+      std::size_t size_;
+      std::vector<double> points_, weights_;
+      std::vector<std::vector<double>> D_; // D[a][b] = l_b'(x_a)
+      std::vector<std::vector<double>> T_; // T[a][b] = l_b(a/p)
+
+      std::vector<std::size_t> dofs_;      // nodes_ per element, lexicographic
+      std::vector<Jacobian> jit_;          // jacobianInverseTransposed per node
+      std::vector<double> wdetJ_;          // quadrature weight times integration element
+      std::vector<Coordinate> positions_;  // GLL node per node
+      std::vector<bool> constrained_;
+      double lambda_, mu_, rho_;
+
+      mutable std::vector<FieldVector<double, dim>> u_, r_;
+      mutable std::vector<Jacobian> flux_;    // w detJ sigma J^-T per node
+
+      // r = (T x T ... x T) u on one element (transposed: T^T), u is overwritten
+      void transform(bool transposed) const
+      {
+        for(int m=0, stride=1; m<dim; m++, stride*=n_) {
+          for(int L=0; L<nodes_; L++) {
+            const int a = (L/stride) % n_;
+            const int base = L - a*stride;
+            r_[L] = 0.0;
+            for(int b=0; b<n_; b++)
+              r_[L].axpy(transposed ? T_[b][a] : T_[a][b], u_[base + b*stride]);
+          }
+          std::swap(u_, r_);
+        }
+        std::swap(u_, r_);
+      }
+
+    public:
+
+      SpectralElementOperator(const Basis& basis, double E, double nu, double rho,
+                              PlaneAssumption assumption = PlaneAssumption::strain)
+        : size_(basis.size()),
+          constrained_(basis.size(), false),
+          rho_(rho)
+      {
+        const IsotropicMaterial<dim> material(E, nu, assumption);
+        lambda_ = material.lambda();
+        mu_ = material.mu();
+
+        auto gridView = basis.gridView();
+        auto localView = basis.localView();
+
+        bool first = true;
+        std::vector<int> lattice;
+        std::vector<FieldVector<double, 1>> values;
+
+        for( const auto& element : elements(gridView)) {
+
+          if(!element.type().isCube())
+            DUNE_THROW(NotImplemented, "spectral elements need a cube grid");
+
+          localView.bind(element);
+          const auto& node = localView.tree().child(0);
+          const auto& localFE = node.finiteElement();
+
+          // 1D GLL points, derivative and transform matrices and the
+          // lexicographic order of the local Lagrange functions (found at the
+          // equidistant nodes)
+          if(first) {
+            const int p = localFE.localBasis().order();
+            n_ = p+1;
+            nodes_ = 1;
+            for(int k=0; k<dim; k++)
+              nodes_ *= n_;
+            gaussLobattoLegendre(n_, points_, weights_);
+
+            std::vector<double> barycentric(n_, 1.0);
+            for(int a=0; a<n_; a++)
+              for(int b=0; b<n_; b++)
+                if(a != b)
+                  barycentric[a] /= points_[a]-points_[b];
+            D_.assign(n_, std::vector<double>(n_, 0.0));
+            for(int a=0; a<n_; a++) {
+              for(int b=0; b<n_; b++) {
+                if(a != b) {
+                  D_[a][b] = barycentric[b]/barycentric[a]/(points_[a]-points_[b]);
+                  D_[a][a] -= D_[a][b];
+                }
+              }
+            }
+
+            T_.assign(n_, std::vector<double>(n_, 1.0));
+            for(int a=0; a<n_; a++)
+              for(int b=0; b<n_; b++)
+                for(int c=0; c<n_; c++)
+                  if(c != b)
+                    T_[a][b] *= (double(a)/p-points_[c])/(points_[b]-points_[c]);
+
+            lattice.resize(nodes_);
+            for(int L=0; L<nodes_; L++) {
+              FieldVector<double, dim> x;
+              for(int k=0, j=L; k<dim; k++, j/=n_)
+                x[k] = double(j%n_)/p;
+              localFE.localBasis().evaluateFunction(x, values);
+              for(std::size_t i=0; i<values.size(); i++)
+                if(std::abs(values[i][0]-1.0) < 1e-8)
+                  lattice[L] = i;
+            }
+
+            u_.resize(nodes_);
+            r_.resize(nodes_);
+            flux_.resize(nodes_);
+            first = false;
+          }
+
+          const auto geometry = element.geometry();
+          for(int L=0; L<nodes_; L++) {
+            dofs_.push_back(localView.index(node.localIndex(lattice[L]))[0]);
+
+            FieldVector<double, dim> x;
+            double weight = 1.0;
+            for(int k=0, j=L; k<dim; k++, j/=n_) {
+              x[k] = points_[j%n_];
+              weight *= weights_[j%n_];
+            }
+            positions_.push_back(geometry.global(x));
+            jit_.push_back(geometry.jacobianInverseTransposed(x));
+            wdetJ_.push_back(weight*geometry.integrationElement(x));
+          }
+        }
+      }
+
+      // GLL quadrature on the GLL nodes, M = diag(rho sum w detJ), e.g. a BDMatrix
+      template<class MatrixType>
+      void lumpedMass(MatrixType& mass) const
+      {
+        for(std::size_t i=0; i<size_; i++)
+          mass[i][i] = 0.0;
+        for(std::size_t q=0; q<dofs_.size(); q++)
+          for(int k=0; k<dim; k++)
+            mass[dofs_[q]][dofs_[q]][k][k] += rho_*wdetJ_[q];
+      }
+
+      // x_i = f(z_i) at the GLL node z_i of dof i
+      template<class VectorType, class F>
+      void interpolate(VectorType& x, const F& f) const
+      {
+        x.resize(size_);
+        for(std::size_t q=0; q<dofs_.size(); q++)
+          x[dofs_[q]] = f(positions_[q]);
+      }
+
+      // y = T x, the lagrange<p> coefficients of the GLL nodal values x
+      template<class VectorType>
+      void lagrangeCoefficients(const VectorType& x, VectorType& y) const
+      {
+        y.resize(size_);
+        const std::size_t elements = dofs_.size()/nodes_;
+        for(std::size_t e=0; e<elements; e++) {
+          const std::size_t* dofs = &dofs_[e*nodes_];
+          for(int L=0; L<nodes_; L++)
+            u_[L] = x[dofs[L]];
+          transform(false);
+          for(int L=0; L<nodes_; L++)
+            y[dofs[L]] = r_[L];
+        }
+      }
+
+      // y = T^T b, the loads on the GLL nodes of the lagrange<p> loads b; a
+      // row of T is the same in every element, so each dof of b enters once
+      template<class VectorType>
+      void nodalLoads(const VectorType& b, VectorType& y) const
+      {
+        y.resize(size_);
+        y = 0.0;
+        std::vector<bool> visited(size_, false);
+        const std::size_t elements = dofs_.size()/nodes_;
+        for(std::size_t e=0; e<elements; e++) {
+          const std::size_t* dofs = &dofs_[e*nodes_];
+          for(int L=0; L<nodes_; L++) {
+            u_[L] = 0.0;
+            if(!visited[dofs[L]])
+              for(int c=0; c<dim; c++)
+                u_[L][c] = b[dofs[L]][c];
+            visited[dofs[L]] = true;
+          }
+          transform(true);
+          for(int L=0; L<nodes_; L++)
+            y[dofs[L]] += r_[L];
+        }
+      }
+
+      // identity rows, e.g. the dirichlet dofs from BoundaryDofs
+      void setConstrained(const std::vector<std::size_t>& dofs)
+      {
+        for(auto d : dofs)
+          constrained_[d] = true;
+      }
+
+      std::size_t N() const { return size_; }
+      std::size_t M() const { return size_; }
+
+      // y += alpha A x
+      template<class VectorType>
+      void usmv(double alpha, const VectorType& x, VectorType& y) const
+      {
+        const std::size_t elements = dofs_.size()/nodes_;
+        for(std::size_t e=0; e<elements; e++) {
+          const std::size_t* dofs = &dofs_[e*nodes_];
+          const Jacobian* jit = &jit_[e*nodes_];
+          const double* wdetJ = &wdetJ_[e*nodes_];
+
+          for(int L=0; L<nodes_; L++)
+            for(int c=0; c<dim; c++)
+              u_[L][c] = x[dofs[L]][c];
+
+          // reference gradients g[c][m] along each direction m with stride n^m
+          for(int L=0; L<nodes_; L++) {
+            Jacobian g(0.0);
+            for(int m=0, stride=1; m<dim; m++, stride*=n_) {
+              const int a = (L/stride) % n_;
+              const int base = L - a*stride;
+              for(int b=0; b<n_; b++)
+                for(int c=0; c<dim; c++)
+                  g[c][m] += D_[a][b]*u_[base + b*stride][c];
+            }
+
+            // physical gradient, strain, stress and the flux w detJ sigma J^-T
+            Jacobian G(0.0);
+            for(int c=0; c<dim; c++)
+              jit[L].mv(g[c], G[c]);
+            double trace = 0.0;
+            for(int c=0; c<dim; c++)
+              trace += G[c][c];
+            Jacobian sigma;
+            for(int c=0; c<dim; c++)
+              for(int k=0; k<dim; k++)
+                sigma[c][k] = mu_*(G[c][k] + G[k][c]) + (c == k ? lambda_*trace : 0.0);
+            for(int c=0; c<dim; c++) {
+              jit[L].mtv(sigma[c], flux_[L][c]);
+              flux_[L][c] *= wdetJ[L];
+            }
+          }
+
+          // transposed derivatives back to the nodes
+          for(int L=0; L<nodes_; L++)
+            r_[L] = 0.0;
+          for(int L=0; L<nodes_; L++) {
+            for(int m=0, stride=1; m<dim; m++, stride*=n_) {
+              const int a = (L/stride) % n_;
+              const int base = L - a*stride;
+              for(int b=0; b<n_; b++)
+                for(int c=0; c<dim; c++)
+                  r_[base + b*stride][c] += D_[a][b]*flux_[L][c][m];
+            }
+          }
+
+          for(int L=0; L<nodes_; L++)
+            if(!constrained_[dofs[L]])
+              y[dofs[L]].axpy(alpha, r_[L]);
+        }
+
+        for(std::size_t i=0; i<size_; i++)
+          if(constrained_[i])
+            y[i].axpy(alpha, x[i]);
+      }
+
+      template<class VectorType>
+      void umv(const VectorType& x, VectorType& y) const { usmv(1.0, x, y); }
+
+      template<class VectorType>
+      void mmv(const VectorType& x, VectorType& y) const { usmv(-1.0, x, y); }
+
+      template<class VectorType>
+      void mv(const VectorType& x, VectorType& y) const
+      {
+        y = 0.0;
+        usmv(1.0, x, y);
+      }
+  };
+}
+
+#endif
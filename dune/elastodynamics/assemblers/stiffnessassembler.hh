@@ -4,8 +4,10 @@
 #ifndef STIFFNESS_ASSEMBLER_HH
 #define STIFFNESS_ASSEMBLER_HH
 
+#include <dune/elastodynamics/assemblers/elasticitykernels.hh>
 #include <dune/elastodynamics/assemblers/hooketensor.hh>
 #include <dune/elastodynamics/assemblers/symmetrictensor.hh>
+#include <dune/elastodynamics/quadraturerules/lumpingquadrature.hh>
 #include <dune/geometry/quadraturerules.hh>
 
 namespace Dune::Elastodynamics {
@@ -15,6 +17,8 @@ namespace Dune::Elastodynamics {
     private:
 
       double E_, nu_;
+      PlaneAssumption assumption_;
+      QuadratureType::Enum quadratureType_;
       
       template <class DeformationGradient, class Strain>
       void computeStrain(DeformationGradient& gradient, Strain& strain) {
@@ -30,12 +34,24 @@ namespace Dune::Elastodynamics {
     
       typedef typename Dune::Matrix<Dune::FieldMatrix<double, 1, 1>> LocalMatrix;
 				
-      StiffnessAssembler(double E, double nu)
-        : E_(E), nu_(nu)
+      // GaussLobatto integrates on the nodal lumping rule of the element (p+1
+      // Gauss-Lobatto points per direction on cubes), the stiffness of the
+      // SpectralElementOperator
+      StiffnessAssembler(double E, double nu, PlaneAssumption assumption = PlaneAssumption::strain,
+                         QuadratureType::Enum quadratureType = QuadratureType::GaussLegendre)
+        : E_(E), nu_(nu), assumption_(assumption), quadratureType_(quadratureType)
       {}
 		
       template <class LocalView>
 	  void assemble(LocalMatrix& localMatrix, LocalView& localView) {
+        const IsotropicMaterial<LocalView::Element::dimension> material(E_, nu_, assumption_);
+        assemble(localMatrix, localView, material);
+      }
+
+      // with a given stress kernel (IsotropicMaterial, SparseHookeTensor, HookeTensor),
+      // e.g. cached per material
+      template <class LocalView, class Tensor>
+	  void assemble(LocalMatrix& localMatrix, LocalView& localView, const Tensor& hookeTensor) {
         
         using Element = typename LocalView::Element;
         auto element = localView.element();
@@ -43,7 +59,9 @@ namespace Dune::Elastodynamics {
         auto geometry = element.geometry();
         const auto& localFE = localView.tree().child(0).finiteElement();
         int order = 2*(dim*localFE.localBasis().order()-1);
-        const auto& quadRule = QuadratureRules<double, dim>::rule(element.type(), order);
+        const auto& quadRule = quadratureType_ == QuadratureType::GaussLobatto
+          ? LumpingQuadratureRules<double, dim>::rule(element.type(), localFE.localBasis().order())
+          : QuadratureRules<double, dim>::rule(element.type(), order);
             
         localMatrix.setSize(localView.size(), localView.size());
         localMatrix = 0.0;
@@ -71,14 +89,12 @@ namespace Dune::Elastodynamics {
 		    }            
           }
 
-          Dune::Elastodynamics::HookeTensor<dim> hookeTensor(E_, nu_);
-
           for( int i=0; i<localFE.size(); i++) {
             for( int k=0; k<dim; k++) {
               auto row = localView.tree().child(k).localIndex(i);  
               SymmetricTensor<dim> stress;
               
-              hookeTensor.C.mv(strain[i][k], stress);  // maybe change to lambda*tr(e)I+2*nu*e
+              hookeTensor.stress(strain[i][k], stress);
 
               for (int j=0; j<localFE.size(); j++) {
                 for( int l=0; l<dim; l++) {
@@ -0,0 +1,238 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef SUBSPACE_ITERATION_HH
+#define SUBSPACE_ITERATION_HH
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/istl/umfpack.hh>
+
+namespace Dune::Elastodynamics {
+
+  // Subspace iteration for the lowest eigenpairs of K x = w^2 M x [Bathe]
+  // the constrained dofs (block indices, e.g. BoundaryDofs::dofs, and single
+  // components of partially constrained nodes) are kept out of the subspace,
+  // the returned eigenvectors are M-orthonormal
+  template <typename MatrixType, typename VectorType>
+  class SubspaceIteration {
+
+    private:
+
+      using DenseMatrix = Dune::DynamicMatrix<double>;
+
+      const MatrixType& mass_;
+      const MatrixType& stiffness_;
+      int maxIterations_, verbosity_;
+      double tol_;
+
+      // 1 on free, 0 on constrained components
+      VectorType free_;
+
+      void removeConstrained(VectorType& x) const
+      {
+        for(std::size_t i=0; i<x.size(); i++)
+          for(std::size_t k=0; k<x[i].size(); k++)
+            x[i][k] *= free_[i][k];
+      }
+
+      // dense generalized eigenproblem A q = l B q via Cholesky and Jacobi rotations
+      static void denseEigen(const DenseMatrix& A, const DenseMatrix& B,
+                             std::vector<double>& lambda, DenseMatrix& Q)
+      {
+        const int n = A.N();
+
+        // B = LL^T
+        DenseMatrix L(n, n, 0.0);
+        for(int j=0; j<n; j++) {
+          double d = B[j][j];
+          for(int k=0; k<j; k++)
+            d -= L[j][k]*L[j][k];
+          L[j][j] = std::sqrt(d);
+          for(int i=j+1; i<n; i++) {
+            double s = B[i][j];
+            for(int k=0; k<j; k++)
+              s -= L[i][k]*L[j][k];
+            L[i][j] = s/L[j][j];
+          }
+        }
+
+        // C = L^-1 A L^-T
+        DenseMatrix W(n, n), C(n, n);
+        for(int c=0; c<n; c++) {
+          for(int i=0; i<n; i++) {
+            double s = A[i][c];
+            for(int k=0; k<i; k++)
+              s -= L[i][k]*W[k][c];
+            W[i][c] = s/L[i][i];
+          }
+        }
+        for(int r=0; r<n; r++) {
+          for(int i=0; i<n; i++) {
+            double s = W[r][i];
+            for(int k=0; k<i; k++)
+              s -= L[i][k]*C[k][r];
+            C[i][r] = s/L[i][i];
+          }
+        }
+
+        // cyclic Jacobi sweeps
+        DenseMatrix V(n, n, 0.0);
+        for(int i=0; i<n; i++)
+          V[i][i] = 1.0;
+
+        for(int sweep=0; sweep<100; sweep++) {
+          double off = 0.0, diag = 0.0;
+          for(int p=0; p<n; p++) {
+            diag += C[p][p]*C[p][p];
+            for(int q=p+1; q<n; q++)
+              off += C[p][q]*C[p][q];
+          }
+          if(off <= 1e-30*diag)
+            break;
+
+          for(int p=0; p<n; p++) {
+            for(int q=p+1; q<n; q++) {
+              if(C[p][q] == 0.0)
+                continue;
+              double theta = (C[q][q]-C[p][p])/(2.0*C[p][q]);
+              double t = (theta >= 0.0 ? 1.0 : -1.0)/(std::abs(theta)+std::sqrt(theta*theta+1.0));
+              double c = 1.0/std::sqrt(t*t+1.0), s = t*c;
+              for(int k=0; k<n; k++) {
+                double ckp = C[k][p], ckq = C[k][q];
+                C[k][p] = c*ckp - s*ckq;
+                C[k][q] = s*ckp + c*ckq;
+              }
+              for(int k=0; k<n; k++) {
+                double cpk = C[p][k], cqk = C[q][k];
+                C[p][k] = c*cpk - s*cqk;
+                C[q][k] = s*cpk + c*cqk;
+              }
+              for(int k=0; k<n; k++) {
+                double vkp = V[k][p], vkq = V[k][q];
+                V[k][p] = c*vkp - s*vkq;
+                V[k][q] = s*vkp + c*vkq;
+              }
+            }
+          }
+        }
+
+        // sort ascending and transform back Q = L^-T V
+        std::vector<int> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return C[a][a] < C[b][b]; });
+
+        lambda.resize(n);
+        Q.resize(n, n);
+        for(int j=0; j<n; j++) {
+          lambda[j] = C[order[j]][order[j]];
+          for(int i=n-1; i>=0; i--) {
+            double s = V[i][order[j]];
+            for(int k=i+1; k<n; k++)
+              s -= L[k][i]*Q[k][j];
+            Q[i][j] = s/L[i][i];
+          }
+        }
+      }
+
+    public:
+
+      SubspaceIteration(const MatrixType& mass,
+                        const MatrixType& stiffness,
+                        const std::vector<std::size_t>& constrained,
+                        int maxIterations = 100,
+                        double tol = 1e-8,
+                        int verbosity = 0,
+                        const std::vector<std::pair<std::size_t, int>>& constrainedComponents = {})
+        : mass_(mass)
+        , stiffness_(stiffness)
+        , maxIterations_(maxIterations)
+        , verbosity_(verbosity)
+        , tol_(tol)
+        , free_(stiffness.N())
+      {
+        free_ = 1.0;
+        for(auto i : constrained)
+          free_[i] = 0.0;
+        for(const auto& [i, k] : constrainedComponents)
+          free_[i][k] = 0.0;
+      }
+
+      // computes the m lowest eigenvalues w^2 and eigenvectors
+      void apply(int m, std::vector<double>& eigenvalues, std::vector<VectorType>& eigenvectors)
+      {
+        const int q = std::min(2*m, m+8);
+        const std::size_t n = stiffness_.N();
+
+        // random start vectors, zero on constrained rows
+        std::mt19937 generator(0);
+        std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+        std::vector<VectorType> X(q, VectorType(n)), Y(q, VectorType(n)), Z(q, VectorType(n));
+        for(auto& x : X) {
+          for(std::size_t i=0; i<n; i++)
+            for(auto& entry : x[i])
+              entry = distribution(generator);
+          removeConstrained(x);
+        }
+
+        UMFPack<MatrixType> solver(stiffness_);
+        InverseOperatorResult statistics;
+
+        DenseMatrix Kr(q, q), Mr(q, q), Q;
+        std::vector<double> lambda, lambdaOld(q, 0.0);
+        VectorType MZ(n);
+
+        int iteration = 0;
+        for(; iteration<maxIterations_; iteration++) {
+
+          // K Z = M X
+          for(int j=0; j<q; j++) {
+            mass_.mv(X[j], Y[j]);
+            VectorType rhs = Y[j];
+            solver.apply(Z[j], rhs, statistics);
+            removeConstrained(Z[j]);
+          }
+
+          // projected operators, K Z is M X already
+          for(int j=0; j<q; j++) {
+            mass_.mv(Z[j], MZ);
+            for(int i=0; i<q; i++) {
+              Kr[i][j] = Z[i].dot(Y[j]);
+              Mr[i][j] = Z[i].dot(MZ);
+            }
+          }
+
+          denseEigen(Kr, Mr, lambda, Q);
+
+          for(int j=0; j<q; j++) {
+            X[j] = 0.0;
+            for(int i=0; i<q; i++)
+              X[j].axpy(Q[i][j], Z[i]);
+          }
+
+          bool converged = true;
+          for(int j=0; j<m; j++)
+            converged = converged and std::abs(lambda[j]-lambdaOld[j]) <= tol_*std::abs(lambda[j]);
+          lambdaOld = lambda;
+
+          if(converged)
+            break;
+        }
+
+        if(verbosity_ > 0)
+          std::cout << "SubspaceIteration: " << iteration << " iterations" << std::endl;
+
+        eigenvalues.assign(lambda.begin(), lambda.begin()+m);
+        eigenvectors.assign(X.begin(), X.begin()+m);
+      }
+  };
+}
+
+#endif
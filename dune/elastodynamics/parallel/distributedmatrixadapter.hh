@@ -0,0 +1,94 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/*
+Distributed operator for a locally assembled (additive) BCRSMatrix, maps a
+consistent vector to a consistent vector and hides the halo exchange behind
+the SpMV of the interior rows
+*/
+
+#ifndef DISTRIBUTED_MATRIX_ADAPTER_HH
+#define DISTRIBUTED_MATRIX_ADAPTER_HH
+
+#include <vector>
+
+#include <dune/istl/operators.hh>
+#include <dune/istl/solvercategory.hh>
+#include <dune/elastodynamics/parallel/dofcommunicator.hh>
+
+template<class Communicator, class Matrix, class Vector>
+class DistributedMatrixAdapter : public Dune::AssembledLinearOperator<Matrix, Vector, Vector> {
+
+  using field_type = typename Vector::field_type;
+
+  private:
+
+    Communicator& communicator_;
+    const Matrix& matrix_;
+    std::vector<std::size_t> borderRows_, interiorRows_;
+    mutable Vector tmp_;
+
+    void multiply(const std::vector<std::size_t>& rows, const Vector& x, Vector& y) const
+    {
+      for(auto r : rows) {
+        y[r] = 0.0;
+        const auto& row = matrix_[r];
+        for(auto col = row.begin(); col != row.end(); ++col)
+          (*col).umv(x[col.index()], y[r]);
+      }
+    }
+
+  public:
+
+    DistributedMatrixAdapter(Communicator& communicator, const Matrix& matrix)
+      : communicator_(communicator),
+        matrix_(matrix),
+        tmp_(matrix.N())
+    {
+      // rows shared with any neighbor need the exchange, all others are interior
+      std::vector<bool> border(matrix_.N(), false);
+      for(std::size_t i=0; i<communicator_.neighbors().size(); i++)
+        for(auto index : communicator_.indices(i))
+          border[index] = true;
+
+      for(std::size_t r=0; r<matrix_.N(); r++) {
+        if(border[r])
+          borderRows_.push_back(r);
+        else
+          interiorRows_.push_back(r);
+      }
+    }
+
+    // y = Ax, x and y consistent
+    virtual void apply(const Vector& x, Vector& y) const override
+    {
+      // border rows first, their sums travel while the interior is computed
+      multiply(borderRows_, x, y);
+      communicator_.start(y);
+      multiply(interiorRows_, x, y);
+      communicator_.template finish<Type::Add>(y);
+    }
+
+    // y += alpha Ax
+    virtual void applyscaleadd(field_type alpha, const Vector& x, Vector& y) const override
+    {
+      apply(x, tmp_);
+      y.axpy(alpha, tmp_);
+    }
+
+    // matrix interface, so the adapter can replace the stiffness in the steppers
+    void mv(const Vector& x, Vector& y) const
+    { apply(x, y); }
+
+    void mmv(const Vector& x, Vector& y) const
+    { applyscaleadd(-1.0, x, y); }
+
+    virtual const Matrix& getmat() const override
+    { return matrix_; }
+
+    virtual Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::sequential; }
+
+};
+
+#endif
@@ -0,0 +1,78 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/*
+Consistency checks of the distributed classes, collective: all ranks have to call them
+*/
+
+#ifndef DISTRIBUTED_VALIDATION_HH
+#define DISTRIBUTED_VALIDATION_HH
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+namespace Dune::Elastodynamics {
+
+  // Checks that every shared dof has exactly one owner, that the operator maps
+  // consistent vectors to consistent vectors (additive matrix, no element
+  // assembled twice) and reports the symmetry defect |(x,Ay)-(Ax,y)|/|(x,Ay)|
+  // measured with the owner-masked scalar product. The symmetry check only
+  // passes for matrices without the (nonsymmetric) row-wise Dirichlet
+  // elimination, so it is printed but not part of the result.
+  template<class Communicator, class Operator, class ScalarProduct>
+  bool validateDistributedSetup(Communicator& communicator, const Operator& op,
+                                const ScalarProduct& scalarProduct,
+                                double tol = 1e-10, bool verbose = true)
+  {
+    using Vector = typename Operator::domain_type;
+    const auto& comm = communicator.gridView().comm();
+    const std::size_t n = op.getmat().N();
+
+    // ownership: the owner flags of all copies sum up to one
+    Vector owner(n);
+    owner = 1.0;
+    for(auto i : communicator.notOwned())
+      owner[i] = 0.0;
+    communicator.add(owner);
+    double ownership = 0.0;
+    for(std::size_t k=0; k<communicator.neighbors().size(); k++)
+      for(auto i : communicator.indices(k))
+        ownership = std::max(ownership, std::abs(owner[i][0]-1.0));
+    ownership = comm.max(ownership);
+
+    std::mt19937 generator(comm.rank());
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    auto random = [&]() {
+      Vector x(n);
+      for(auto& block : x)
+        for(auto& entry : block)
+          entry = distribution(generator);
+      communicator.makeConsistent(x);
+      return x;
+    };
+
+    // consistency: A x agrees with the owner's copy of A x
+    Vector x = random(), y = random(), Ax(n), Ay(n), z(n);
+    op.apply(x, Ax);
+    op.apply(y, Ay);
+    z = Ax;
+    communicator.makeConsistent(z);
+    z -= Ax;
+    const double consistency = comm.max(z.infinity_norm())/std::max(comm.max(Ax.infinity_norm()), 1e-300);
+
+    const double xAy = scalarProduct.dot(x, Ay);
+    const double symmetry = std::abs(xAy - scalarProduct.dot(Ax, y))/std::max(std::abs(xAy), 1e-300);
+
+    const bool ok = ownership < tol and consistency < tol;
+    if(verbose and comm.rank() == 0)
+      std::cout << "distributed setup: ownership " << ownership
+                << ", consistency " << consistency
+                << ", symmetry " << symmetry
+                << (ok ? " (ok)" : " (FAILED)") << std::endl;
+    return ok;
+  }
+}
+
+#endif
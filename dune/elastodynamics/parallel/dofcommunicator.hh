@@ -0,0 +1,286 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/*
+Communicator with cached send/receive index lists per neighbor rank, built
+once from the grid interface, exchanges use persistent nonblocking requests
+*/
+
+#ifndef DOF_COMMUNICATOR_HH
+#define DOF_COMMUNICATOR_HH
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/gridenums.hh>
+#include <dune/elastodynamics/parallel/femdatahandle.hh>
+
+template<class Basis, class Vector>
+class DofCommunicator {
+
+  private:
+
+    using GridView = typename Basis::GridView;
+    using IdType = typename GridView::Grid::GlobalIdSet::IdType;
+    using Block = typename Vector::block_type;
+    static const int blockSize = Block::dimension;
+
+    // records which entities are shared with which rank
+    class SetupHandle : public Dune::CommDataHandleIF<SetupHandle, int> {
+
+      private:
+
+        const EntityDofMap<Basis>& dofMap_;
+        std::map<int, std::vector<std::pair<IdType, std::vector<std::size_t>>>>& shared_;
+        int rank_;
+
+      public:
+
+        SetupHandle(const EntityDofMap<Basis>& dofMap,
+                    std::map<int, std::vector<std::pair<IdType, std::vector<std::size_t>>>>& shared,
+                    int rank)
+          : dofMap_(dofMap), shared_(shared), rank_(rank)
+        {}
+
+        bool contains(int dim, int codim) const
+        { return dofMap_.contains(codim); }
+
+        bool fixedSize(int dim, int codim) const
+        { return true; }
+
+        template<class Entity>
+        size_t size(const Entity& entity) const
+        { return 1; }
+
+        template<class MessageBuffer, class Entity>
+        void gather(MessageBuffer& buffer, const Entity& entity) const
+        { buffer.write(rank_); }
+
+        template<class MessageBuffer, class Entity>
+        void scatter(MessageBuffer& buffer, const Entity& entity, size_t n)
+        {
+          int rank;
+          buffer.read(rank);
+          if(dofMap_.size(entity) == 0)
+            return;
+          const auto& idSet = dofMap_.gridView().grid().globalIdSet();
+          shared_[rank].emplace_back(idSet.id(entity),
+                                     std::vector<std::size_t>(dofMap_.begin(entity), dofMap_.end(entity)));
+        }
+    };
+
+    // a dof is owned by the lowest rank holding it as interior or border
+    class OwnerHandle : public Dune::CommDataHandleIF<OwnerHandle, int> {
+
+      private:
+
+        const EntityDofMap<Basis>& dofMap_;
+        std::vector<bool>& owned_;
+        int rank_;
+
+        template<class Entity>
+        int claim(const Entity& entity) const
+        {
+          auto type = entity.partitionType();
+          return (type == Dune::InteriorEntity or type == Dune::BorderEntity) ? rank_ : std::numeric_limits<int>::max();
+        }
+
+      public:
+
+        OwnerHandle(const EntityDofMap<Basis>& dofMap, std::vector<bool>& owned, int rank)
+          : dofMap_(dofMap), owned_(owned), rank_(rank)
+        {}
+
+        bool contains(int dim, int codim) const
+        { return dofMap_.contains(codim); }
+
+        bool fixedSize(int dim, int codim) const
+        { return true; }
+
+        template<class Entity>
+        size_t size(const Entity& entity) const
+        { return 1; }
+
+        template<class MessageBuffer, class Entity>
+        void gather(MessageBuffer& buffer, const Entity& entity) const
+        { buffer.write(claim(entity)); }
+
+        template<class MessageBuffer, class Entity>
+        void scatter(MessageBuffer& buffer, const Entity& entity, size_t n)
+        {
+          int other;
+          buffer.read(other);
+          if(claim(entity) > rank_ or other < rank_)
+            for(auto it = dofMap_.begin(entity); it != dofMap_.end(entity); ++it)
+              owned_[*it] = false;
+        }
+    };
+
+    const GridView gridView_;
+
+    std::vector<int> neighbors_;
+    std::vector<std::size_t> notOwned_;
+    std::vector<std::vector<std::size_t>> indices_;
+    std::vector<std::vector<double>> sendBuffers_, receiveBuffers_;
+
+#if HAVE_MPI
+    MPI_Comm comm_;
+    std::vector<MPI_Request> requests_;
+    MPI_Request sumRequest_ = MPI_REQUEST_NULL;
+#endif
+    std::vector<double> sumBuffer_;
+
+  public:
+
+    using VectorType = Vector;
+
+    DofCommunicator(const EntityDofMap<Basis>& dofMap,
+                    Dune::InterfaceType interface = Dune::InteriorBorder_InteriorBorder_Interface)
+      : gridView_(dofMap.gridView())
+    {
+      std::map<int, std::vector<std::pair<IdType, std::vector<std::size_t>>>> shared;
+      SetupHandle handle(dofMap, shared, gridView_.comm().rank());
+      gridView_.communicate(handle, interface, Dune::ForwardCommunication);
+
+      // both sides sort by global id, so the lists agree without further communication
+      for(auto& neighbor : shared) {
+        auto& entities = neighbor.second;
+        std::sort(entities.begin(), entities.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        neighbors_.push_back(neighbor.first);
+        indices_.emplace_back();
+        for(const auto& entity : entities)
+          indices_.back().insert(indices_.back().end(), entity.second.begin(), entity.second.end());
+
+        sendBuffers_.emplace_back(indices_.back().size()*blockSize);
+        receiveBuffers_.emplace_back(indices_.back().size()*blockSize);
+      }
+
+      // ownership from the partition types, all copies are seen over All_All
+      std::vector<bool> owned(dofMap.size(), true);
+      OwnerHandle ownerHandle(dofMap, owned, gridView_.comm().rank());
+      gridView_.communicate(ownerHandle, Dune::All_All_Interface, Dune::ForwardCommunication);
+      for(std::size_t i=0; i<owned.size(); i++)
+        if(!owned[i])
+          notOwned_.push_back(i);
+
+#if HAVE_MPI
+      comm_ = gridView_.comm();
+      const int n = neighbors_.size();
+      requests_.resize(2*n);
+      for(int i=0; i<n; i++) {
+        MPI_Recv_init(receiveBuffers_[i].data(), receiveBuffers_[i].size(), MPI_DOUBLE,
+                      neighbors_[i], 0, comm_, &requests_[i]);
+        MPI_Send_init(sendBuffers_[i].data(), sendBuffers_[i].size(), MPI_DOUBLE,
+                      neighbors_[i], 0, comm_, &requests_[n+i]);
+      }
+#endif
+    }
+
+    DofCommunicator(const DofCommunicator&) = delete;
+    DofCommunicator& operator=(const DofCommunicator&) = delete;
+
+    ~DofCommunicator()
+    {
+#if HAVE_MPI
+      for(auto& request : requests_)
+        MPI_Request_free(&request);
+#endif
+    }
+
+    const GridView& gridView() const
+    { return gridView_; }
+
+    const std::vector<int>& neighbors() const
+    { return neighbors_; }
+
+    // dofs counted by another rank in global reductions
+    const std::vector<std::size_t>& notOwned() const
+    { return notOwned_; }
+
+    // dofs shared with the i-th neighbor, same order on both ranks
+    const std::vector<std::size_t>& indices(int i) const
+    { return indices_[i]; }
+
+    // packs the shared values and posts the messages
+    void start(const Vector& vector)
+    {
+      for(std::size_t i=0; i<neighbors_.size(); i++) {
+        double* buffer = sendBuffers_[i].data();
+        for(auto index : indices_[i])
+          for(int k=0; k<blockSize; k++)
+            *buffer++ = vector[index][k];
+      }
+#if HAVE_MPI
+      if(!requests_.empty())
+        MPI_Startall(requests_.size(), requests_.data());
+#endif
+    }
+
+    // waits for the messages and applies Operation (Type::Add, Type::Equal)
+    template<class Operation>
+    void finish(Vector& vector)
+    {
+#if HAVE_MPI
+      if(!requests_.empty())
+        MPI_Waitall(requests_.size(), requests_.data(), MPI_STATUSES_IGNORE);
+#endif
+      for(std::size_t i=0; i<neighbors_.size(); i++) {
+        const double* buffer = receiveBuffers_[i].data();
+        for(auto index : indices_[i]) {
+          Block x;
+          for(int k=0; k<blockSize; k++)
+            x[k] = *buffer++;
+          Operation::apply(vector[index], x);
+        }
+      }
+    }
+
+    template<class Operation>
+    void exchange(Vector& vector)
+    {
+      start(vector);
+      finish<Operation>(vector);
+    }
+
+    // sum of the values of all ranks sharing a dof
+    void add(Vector& vector)
+    { exchange<Type::Add>(vector); }
+
+    // every copy takes the value of the owning rank, e.g. to make a rank-local
+    // random or initial vector consistent
+    void makeConsistent(Vector& vector)
+    {
+      for(auto i : notOwned_)
+        vector[i] = 0.0;
+      add(vector);
+    }
+
+    // nonblocking global sum of n values, the result is written back to values
+    // by finishSum(), values must stay alive in between
+    void startSum(double* values, int n)
+    {
+#if HAVE_MPI
+      sumBuffer_.assign(values, values+n);
+      MPI_Iallreduce(sumBuffer_.data(), values, n, MPI_DOUBLE, MPI_SUM, comm_, &sumRequest_);
+#endif
+    }
+
+    void finishSum()
+    {
+#if HAVE_MPI
+      MPI_Wait(&sumRequest_, MPI_STATUS_IGNORE);
+#endif
+    }
+};
+
+#endif
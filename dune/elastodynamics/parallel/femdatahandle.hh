@@ -2,89 +2,248 @@
 // vi: set et ts=4 sw=2 sts=2:
 
 /*
-This is a prototype version for a FEM data handle!
+FEM data handle communicating all dofs of a power<dim>(lagrange<p>()) basis,
+not only the vertex values like VectorExchange in vectordatahandle.hh
 */
 
-#ifndef VECTOR_DATA_HANDLE_HH
-#define VECTOR_DATA_HANDLE_HH
+#ifndef FEM_DATA_HANDLE_HH
+#define FEM_DATA_HANDLE_HH
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/geometry/referenceelements.hh>
 #include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/partitionset.hh>
+#include <dune/elastodynamics/parallel/vectordatahandle.hh>
 
-namespace Type
-{
-  struct Equal
-  {
-    template<class A, class B>
-    static void apply(A& a, const B& b)
-    { a = b; }
-  };
-    
-  struct Add
-  {
-    template<class A, class B>
-    static void apply(A& a, const B& b)
-    { a += b; }
-  };
-}
-
-template<class Basis, class Vector, class Operation>	
-class VectorExchange : public Dune::CommDataHandleIF<VectorExchange<Basis, Vector, Operation>, typename Vector::value_type> {
+// Map from grid entities (all codims) to the global block indices of the dofs
+// attached to them. Built once, every exchange is a flat loop over these lists.
+// The dofs of an entity are sent in an order that agrees on all ranks:
+// - edges: ordered from the vertex with the smaller global id
+// - faces (3D): the Lagrange nodes are sorted by their weights of the face
+//   vertices (the P1/Q1 vertex functions at the node), the vertices taken in the
+//   order of their global ids. Needs a nodal basis and simplex or cube elements.
+template<class Basis>
+class EntityDofMap {
 
   private:
-      
-    const Basis& basis_;
+
+    using GridView = typename Basis::GridView;
+    static const int dim = GridView::dimension;
+    using Key = std::pair<std::vector<double>, std::size_t>;
+
+    const GridView gridView_;
+    std::array<std::vector<std::size_t>, dim+1> offsets_, indices_;
+    std::size_t size_;
+
+    // P1/Q1 function of an element vertex at x, on a face the weight of the face vertex
+    static double vertexWeight(const Dune::GeometryType& type, int vertex, const Dune::FieldVector<double, dim>& x)
+    {
+      if(type.isCube()) {
+        double weight = 1.0;
+        for(int k=0; k<dim; k++)
+          weight *= ((vertex >> k) & 1) ? x[k] : 1.0-x[k];
+        return weight;
+      }
+      if(type.isSimplex()) {
+        if(vertex > 0)
+          return x[vertex-1];
+        double weight = 1.0;
+        for(int k=0; k<dim; k++)
+          weight -= x[k];
+        return weight;
+      }
+      DUNE_THROW(Dune::NotImplemented, "face dofs are only oriented on simplex and cube elements");
+    }
+
+    // lexicographic, the weights are equal on all ranks up to rounding
+    static bool less(const Key& a, const Key& b)
+    {
+      for(std::size_t k=0; k<a.first.size(); k++)
+        if(std::abs(a.first[k]-b.first[k]) > 1e-8)
+          return a.first[k] < b.first[k];
+      return false;
+    }
+
+  public:
+
+    EntityDofMap(const Basis& basis)
+      : gridView_(basis.gridView())
+      , size_(basis.size())
+    {
+      const auto& indexSet = gridView_.indexSet();
+      const auto& idSet = gridView_.grid().globalIdSet();
+      auto localView = basis.localView();
+
+      std::array<std::vector<std::vector<std::size_t>>, dim+1> dofs;
+      for(int c=0; c<=dim; c++)
+        dofs[c].resize(indexSet.size(c));
+      std::vector<bool> faceDone(dim == 3 ? indexSet.size(1) : 0, false);
+      std::vector<Dune::FieldVector<double, dim>> nodes;
+      std::vector<double> coefficients;
+
+      for(const auto& element : elements(gridView_, Dune::Partitions::all)) {
+
+        localView.bind(element);
+        const auto& node = localView.tree().child(0);
+        const auto& localFE = node.finiteElement();
+        const auto& localCoefficients = localFE.localCoefficients();
+        const int edgeDofs = localFE.localBasis().order()-1;
+        auto ref = Dune::referenceElement<double, dim>(element.type());
+        std::map<std::size_t, std::vector<Key>> faceKeys;
+
+        // the Lagrange nodes, only needed for the face dofs
+        if(dim == 3 and edgeDofs > 1) {
+          nodes.clear();
+          localFE.localInterpolation().interpolate([&](const Dune::FieldVector<double, dim>& x) {
+            nodes.push_back(x);
+            return 0.0;
+          }, coefficients);
+          if(nodes.size() != localFE.size())
+            DUNE_THROW(Dune::NotImplemented, "face dofs are only oriented for a nodal (Lagrange) basis");
+        }
+
+        for(std::size_t i=0; i<node.size(); i++) {
+          const auto& key = localCoefficients.localKey(i);
+          const auto entity = indexSet.subIndex(element, key.subEntity(), key.codim());
+          auto& entityDofs = dofs[key.codim()][entity];
+
+          if(dim == 3 and key.codim() == 1) {
+            if(faceDone[entity])
+              continue;
+            std::vector<std::pair<typename GridView::Grid::GlobalIdSet::IdType, int>> vertices;
+            for(int j=0; j<ref.size(key.subEntity(), 1, dim); j++) {
+              const int v = ref.subEntity(key.subEntity(), 1, j, dim);
+              vertices.emplace_back(idSet.subId(element, v, dim), v);
+            }
+            std::sort(vertices.begin(), vertices.end());
+            std::vector<double> weights;
+            for(const auto& vertex : vertices)
+              weights.push_back(nodes.empty() ? 0.0 : vertexWeight(element.type(), vertex.second, nodes[i]));
+            faceKeys[entity].emplace_back(weights, localView.index(node.localIndex(i))[0]);
+            continue;
+          }
+
+          std::size_t slot = key.index();
+          if(dim > 1 and key.codim() == dim-1 and edgeDofs > 1) {
+            auto id0 = idSet.subId(element, ref.subEntity(key.subEntity(), dim-1, 0, dim), dim);
+            auto id1 = idSet.subId(element, ref.subEntity(key.subEntity(), dim-1, 1, dim), dim);
+            if(id1 < id0)
+              slot = edgeDofs-1-key.index();
+          }
+
+          if(entityDofs.size() <= slot)
+            entityDofs.resize(slot+1);
+          entityDofs[slot] = localView.index(node.localIndex(i))[0];
+        }
+
+        for(auto& [face, keys] : faceKeys) {
+          std::sort(keys.begin(), keys.end(), less);
+          for(const auto& key : keys)
+            dofs[1][face].push_back(key.second);
+          faceDone[face] = true;
+        }
+      }
+
+      // flatten
+      for(int c=0; c<=dim; c++) {
+        offsets_[c].assign(1, 0);
+        for(const auto& entityDofs : dofs[c]) {
+          indices_[c].insert(indices_[c].end(), entityDofs.begin(), entityDofs.end());
+          offsets_[c].push_back(indices_[c].size());
+        }
+      }
+    }
+
+    const GridView& gridView() const
+    { return gridView_; }
+
+    // number of dof blocks
+    std::size_t size() const
+    { return size_; }
+
+    bool contains(int codim) const
+    { return indices_[codim].size() > 0; }
+
+    template<class Entity>
+    std::size_t size(const Entity& entity) const
+    {
+      const int c = Entity::codimension;
+      auto e = gridView_.indexSet().index(entity);
+      return offsets_[c][e+1] - offsets_[c][e];
+    }
+
+    template<class Entity>
+    const std::size_t* begin(const Entity& entity) const
+    {
+      const int c = Entity::codimension;
+      return indices_[c].data() + offsets_[c][gridView_.indexSet().index(entity)];
+    }
+
+    template<class Entity>
+    const std::size_t* end(const Entity& entity) const
+    {
+      const int c = Entity::codimension;
+      return indices_[c].data() + offsets_[c][gridView_.indexSet().index(entity)+1];
+    }
+};
+
+template<class Basis, class Vector, class Operation>
+class BasisVectorExchange : public Dune::CommDataHandleIF<BasisVectorExchange<Basis, Vector, Operation>, typename Vector::value_type> {
+
+  private:
+
+    const EntityDofMap<Basis>& dofMap_;
     Vector& vector_;
 
   public:
-      
+
     typedef typename Vector::value_type DataType;
-    
-    VectorExchange(const Basis& basis, Vector& vector)  
-      : basis_(basis), vector_(vector)
+
+    BasisVectorExchange(const EntityDofMap<Basis>& dofMap, Vector& vector)
+      : dofMap_(dofMap), vector_(vector)
     {}
-    
-    // we want to first operate on the element
+
+    // all codims carrying dofs
     bool contains(int dim, int codim) const
-    { return (codim == 0); }
-    
+    { return dofMap_.contains(codim); }
+
     bool fixedSize(int dim, int codim) const
-    { return true; }
-    
+    { return false; }
+
     template<class Entity>
     size_t size(const Entity& entity) const
-    { return 1; }
-
-    // This doesn't work like I expected it to be ...... 
+    { return dofMap_.size(entity); }
 
     template<class MessageBuffer, class Entity>
     void gather(MessageBuffer& buffer, const Entity& entity) const
     {
-      auto localView = basis_.localView();
-      //localView.bind(entity);
-      const auto& localFE = localView.tree().child(0).finiteElement();
-      for( size_t i=0; i<localFE.size(); i++) {
-        buffer.write(vector_[localView.index(i)[0]]);
-      }   
+      for(auto it = dofMap_.begin(entity); it != dofMap_.end(entity); ++it)
+        buffer.write(vector_[*it]);
     }
-    
+
     template<class MessageBuffer, class Entity>
     void scatter(MessageBuffer& buffer, const Entity& entity, size_t n) const
     {
-      auto localView = basis_.localView();
-      localView.bind(entity);
       DataType x;
-      buffer.read(x);
-      const auto& localFE = localView.tree().child(0).finiteElement();
-      for( size_t i=0; i<localFE.size(); i++) {
-        Operation::apply(vector_[localView.index(i)[0]], x);
+      for(auto it = dofMap_.begin(entity); it != dofMap_.end(entity); ++it) {
+        buffer.read(x);
+        Operation::apply(vector_[*it], x);
       }
     }
 };
 
 template<class Basis, class Vector>
-using VectorExchangeEqual = VectorExchange<Basis, Vector, Type::Equal>;
+using BasisVectorExchangeEqual = BasisVectorExchange<Basis, Vector, Type::Equal>;
 
 template<class Basis, class Vector>
-using VectorExchangeAdd = VectorExchange<Basis, Vector, Type::Add>;
+using BasisVectorExchangeAdd = BasisVectorExchange<Basis, Vector, Type::Add>;
 
 #endif
@@ -0,0 +1,113 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef BLOCK_SMOOTHERS_HH
+#define BLOCK_SMOOTHERS_HH
+
+#include <vector>
+
+namespace Dune::Elastodynamics {
+
+  // point-block smoothers shared by the multigrid preconditioners, they work on
+  // the nodal dim x dim blocks of the BCRSMatrix
+
+  // inverted diagonal blocks
+  template<class Matrix>
+  std::vector<typename Matrix::block_type> invertedDiagonal(const Matrix& A)
+  {
+    std::vector<typename Matrix::block_type> Dinv(A.N());
+    for(std::size_t i=0; i<A.N(); i++) {
+      Dinv[i] = A[i][i];
+      Dinv[i].invert();
+    }
+    return Dinv;
+  }
+
+  // block Gauss-Seidel sweep, forward and backward sweep together are symmetric
+  template<class Matrix, class Block, class Vector>
+  void blockGaussSeidel(const Matrix& A, const std::vector<Block>& Dinv,
+                        Vector& x, const Vector& b, bool forward)
+  {
+    const int n = A.N();
+    typename Vector::block_type s;
+    for(int k=0; k<n; k++) {
+      const int i = forward ? k : n-1-k;
+      s = b[i];
+      for(auto col = A[i].begin(); col != A[i].end(); ++col)
+        if(col.index() != std::size_t(i))
+          (*col).mmv(x[col.index()], s);
+      Dinv[i].mv(s, x[i]);
+    }
+  }
+
+  // damped block Jacobi step x += omega D^-1 (b - Ax), r is workspace
+  template<class Matrix, class Block, class Vector>
+  void blockJacobi(const Matrix& A, const std::vector<Block>& Dinv,
+                   Vector& x, const Vector& b, double omega, Vector& r)
+  {
+    r = b;
+    A.mmv(x, r);
+    for(std::size_t i=0; i<x.size(); i++)
+      Dinv[i].usmv(omega, r[i], x[i]);
+  }
+
+  // largest eigenvalue of D^-1 A by power iteration
+  template<class Vector, class Matrix, class Block>
+  double blockJacobiLambdaMax(const Matrix& A, const std::vector<Block>& Dinv, int iterations = 15)
+  {
+    Vector x(A.N()), y(A.N()), z(A.N());
+    for(std::size_t i=0; i<x.size(); i++)
+      for(std::size_t k=0; k<x[i].size(); k++)
+        x[i][k] = 1.0 + 0.1*((7*i+k) % 13);
+
+    double lambda = 1.0;
+    for(int it=0; it<iterations; it++) {
+      x /= x.two_norm();
+      A.mv(x, z);
+      for(std::size_t i=0; i<x.size(); i++)
+        Dinv[i].mv(z[i], y[i]);
+      lambda = x.dot(y);
+      x = y;
+    }
+    return lambda;
+  }
+
+  // Chebyshev iteration on D^-1 A for eigenvalues in [lower, upper] [Saad], only
+  // products with A and no inner products, so the distributed version needs halo
+  // exchanges but no reductions. With a zero initial guess one product is saved,
+  // x := p(D^-1 A) D^-1 b is then a fixed symmetric polynomial. r, d are workspace.
+  template<class Operator, class Block, class Vector>
+  void blockChebyshev(const Operator& A, const std::vector<Block>& Dinv,
+                      Vector& x, const Vector& b, double lower, double upper, int degree,
+                      bool zeroInitialGuess, Vector& r, Vector& d)
+  {
+    const double theta = 0.5*(upper+lower), delta = 0.5*(upper-lower);
+    const double sigma = theta/delta;
+    double rho = 1.0/sigma;
+
+    r = b;
+    if(zeroInitialGuess)
+      x = 0.0;
+    else
+      A.mmv(x, r);
+
+    for(std::size_t i=0; i<x.size(); i++) {
+      Dinv[i].mv(r[i], d[i]);
+      d[i] /= theta;
+    }
+
+    for(int k=0; k<degree; k++) {
+      x += d;
+      if(k+1 == degree)
+        break;
+      A.mmv(d, r);
+      const double rhoNew = 1.0/(2.0*sigma - rho);
+      d *= rhoNew*rho;
+      for(std::size_t i=0; i<x.size(); i++)
+        Dinv[i].usmv(2.0*rhoNew/delta, r[i], d[i]);
+      rho = rhoNew;
+    }
+  }
+}
+
+#endif
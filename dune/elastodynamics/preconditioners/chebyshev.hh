@@ -0,0 +1,163 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef CHEBYSHEV_HH
+#define CHEBYSHEV_HH
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+#include <dune/elastodynamics/preconditioners/blocksmoothers.hh>
+
+// number of eigenvalues of the symmetric tridiagonal matrix below x (Sturm sequence)
+inline int sturmCount(const std::vector<double>& diagonal, const std::vector<double>& offDiagonal, double x)
+{
+  int count = 0;
+  double q = 1.0;
+  for(std::size_t i=0; i<diagonal.size(); i++) {
+    const double e = i > 0 ? offDiagonal[i-1] : 0.0;
+    q = diagonal[i] - x - (i > 0 ? e*e/q : 0.0);
+    if(q == 0.0)
+      q = 1e-300;
+    if(q < 0.0)
+      count++;
+  }
+  return count;
+}
+
+// extreme eigenvalues of D^-1 A from the coefficients of a few preconditioned CG
+// steps (Lanczos tridiagonal), D^-1 are the inverted nodal blocks. Works with
+// Matrix/SeqScalarProduct as well as DistributedMatrixAdapter/DistributedScalarProduct,
+// the start vector A x is consistent even for a rank-local x. The largest Ritz
+// value is a lower bound of lambda_max, the smallest an upper bound of lambda_min.
+template<class Vector, class Operator, class Block, class ScalarProduct>
+std::pair<double, double> lanczosBounds(const Operator& A, const std::vector<Block>& Dinv,
+                                        const ScalarProduct& scalarProduct, int steps = 10)
+{
+  const std::size_t n = Dinv.size();
+  Vector x(n), r(n), z(n), p(n), q(n);
+  for(std::size_t i=0; i<n; i++)
+    for(std::size_t k=0; k<x[i].size(); k++)
+      x[i][k] = 1.0 + 0.1*((7*i+k) % 13);
+  A.mv(x, r);
+
+  std::vector<double> diagonal, offDiagonal;
+  for(std::size_t i=0; i<n; i++)
+    Dinv[i].mv(r[i], z[i]);
+  p = z;
+  double rz = scalarProduct.dot(r, z), alphaOld = 1.0, betaOld = 0.0;
+
+  for(int j=0; j<steps and rz > 0.0; j++) {
+    A.mv(p, q);
+    const double alpha = rz/scalarProduct.dot(p, q);
+    r.axpy(-alpha, q);
+    for(std::size_t i=0; i<n; i++)
+      Dinv[i].mv(r[i], z[i]);
+    const double rzNew = scalarProduct.dot(r, z);
+    const double beta = rzNew/rz;
+
+    diagonal.push_back(1.0/alpha + (j > 0 ? betaOld/alphaOld : 0.0));
+    offDiagonal.push_back(std::sqrt(std::abs(beta))/alpha);
+
+    p *= beta;
+    p += z;
+    rz = rzNew;
+    alphaOld = alpha;
+    betaOld = beta;
+  }
+
+  const int m = diagonal.size();
+  if(m == 0)
+    return {1.0, 1.0};
+
+  // bisection inside the Gershgorin interval
+  double lower = diagonal[0], upper = diagonal[0];
+  for(int i=0; i<m; i++) {
+    const double radius = (i > 0 ? std::abs(offDiagonal[i-1]) : 0.0) + (i+1 < m ? std::abs(offDiagonal[i]) : 0.0);
+    lower = std::min(lower, diagonal[i]-radius);
+    upper = std::max(upper, diagonal[i]+radius);
+  }
+
+  auto eigenvalue = [&](int index) {
+    double a = lower, b = upper;
+    for(int it=0; it<100 and b-a > 1e-12*std::abs(upper); it++) {
+      const double c = 0.5*(a+b);
+      if(sturmCount(diagonal, offDiagonal, c) > index)
+        b = c;
+      else
+        a = c;
+    }
+    return 0.5*(a+b);
+  };
+
+  return {eigenvalue(0), eigenvalue(m-1)};
+}
+
+// Chebyshev polynomial preconditioner/smoother on D^-1 A. Applying it costs
+// degree-1 products with A and no inner products. The operator is a BCRSMatrix or
+// a DistributedMatrixAdapter (with consistentInvertedDiagonal), in the distributed
+// case the output stays consistent. The bounds are estimated by Lanczos: as a
+// preconditioner the whole spectrum is targeted, as a smoother (lowerRatio > 0)
+// only [lowerRatio*lambda_max, lambda_max].
+template<class Operator, class Vector>
+class ChebyshevPreconditioner : public Dune::Preconditioner<Vector, Vector> {
+
+  public:
+
+    using Block = Dune::FieldMatrix<double, Vector::block_type::dimension, Vector::block_type::dimension>;
+
+  private:
+
+    const Operator& operator_;
+    std::vector<Block> Dinv_;
+    double lower_, upper_;
+    int degree_;
+    Vector r_, d_;
+
+  public:
+
+    ChebyshevPreconditioner(const Operator& op, const std::vector<Block>& Dinv,
+                            double lower, double upper, int degree)
+      : operator_(op),
+        Dinv_(Dinv),
+        lower_(lower),
+        upper_(upper),
+        degree_(degree),
+        r_(Dinv.size()),
+        d_(Dinv.size())
+    {}
+
+    template<class ScalarProduct>
+    ChebyshevPreconditioner(const Operator& op, const std::vector<Block>& Dinv,
+                            const ScalarProduct& scalarProduct, int degree,
+                            int lanczosSteps = 10, double lowerRatio = 0.0)
+      : ChebyshevPreconditioner(op, Dinv, 0.0, 0.0, degree)
+    {
+      auto bounds = lanczosBounds<Vector>(op, Dinv, scalarProduct, lanczosSteps);
+      upper_ = 1.1*bounds.second;
+      lower_ = lowerRatio > 0.0 ? lowerRatio*upper_ : 0.9*bounds.first;
+    }
+
+    virtual void pre (Vector& x, Vector& b) {}
+
+    virtual void apply (Vector& v, const Vector& d)
+    {
+      Dune::Elastodynamics::blockChebyshev(operator_, Dinv_, v, d, lower_, upper_, degree_, true, r_, d_);
+    }
+
+    virtual void post (Vector& x) {}
+
+    double lowerBound() const { return lower_; }
+    double upperBound() const { return upper_; }
+
+    virtual Dune::SolverCategory::Category category() const
+    { return Dune::SolverCategory::sequential; }
+
+};
+
+#endif
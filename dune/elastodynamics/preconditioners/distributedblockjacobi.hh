@@ -0,0 +1,79 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DISTRIBUTED_BLOCK_JACOBI_HH
+#define DISTRIBUTED_BLOCK_JACOBI_HH
+
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+#include <dune/elastodynamics/parallel/dofcommunicator.hh>
+
+// inverted nodal blocks of the consistent (summed) diagonal, the blocks of the
+// shared dofs are summed column by column
+template<class Communicator, class Matrix>
+std::vector<typename Matrix::block_type> consistentInvertedDiagonal(Communicator& communicator, const Matrix& matrix)
+{
+  using Block = typename Matrix::block_type;
+  const int blockSize = Block::rows;
+
+  std::vector<Block> Dinv(matrix.N());
+  Dune::BlockVector<Dune::FieldVector<double, blockSize>> column(matrix.N());
+  for(int j=0; j<blockSize; j++) {
+    for(std::size_t i=0; i<matrix.N(); i++)
+      for(int k=0; k<blockSize; k++)
+        column[i][k] = matrix[i][i][k][j];
+    communicator.add(column);
+    for(std::size_t i=0; i<matrix.N(); i++)
+      for(int k=0; k<blockSize; k++)
+        Dinv[i][k][j] = column[i][k];
+  }
+
+  for(auto& block : Dinv)
+    block.invert();
+  return Dinv;
+}
+
+// point-block Jacobi, inverts the full consistent dim x dim nodal block
+// instead of only its diagonal like DistributedJacobi
+template<class Communicator, class Matrix, class Vector>
+class DistributedBlockJacobi : public Dune::Preconditioner<Vector, Vector> {
+
+  private:
+
+    using Block = typename Matrix::block_type;
+
+    Communicator& communicator_;
+    std::vector<Block> inverseDiagonal_;
+    double relaxation_;
+    
+  public:
+
+    DistributedBlockJacobi(Communicator& communicator, const Matrix& matrix, double relaxation = 1.0)
+      : communicator_(communicator),
+        inverseDiagonal_(consistentInvertedDiagonal(communicator, matrix)),
+        relaxation_(relaxation)
+    {}
+
+    virtual void pre (Vector& x, Vector& b) {}
+
+    // r is consistent, so no exchange is needed
+    virtual void apply (Vector& v, const Vector& r)
+    {
+      for(std::size_t i=0; i<inverseDiagonal_.size(); i++) {
+        inverseDiagonal_[i].mv(r[i], v[i]);
+        v[i] *= relaxation_;
+      }
+    }
+
+    virtual void post (Vector& x) {}
+
+    virtual Dune::SolverCategory::Category category() const
+    { return Dune::SolverCategory::sequential; }
+
+};
+
+#endif
@@ -11,45 +11,44 @@ Numerics Environment by Oliver Sander and is modified!
 
 #include <dune/istl/preconditioner.hh>
 #include <dune/istl/solvercategory.hh>
-#include <dune/elastodynamics/parallel/vectordatahandle.hh>
+#include <dune/elastodynamics/parallel/dofcommunicator.hh>
 
-template<class GridView, class Matrix, class Vector>
+template<class Communicator, class Matrix, class Vector>
 class DistributedJacobi : public Dune::Preconditioner<Vector, Vector> {
 
   private:
 
-    const GridView& gridView_;
+    static const int blockSize = Vector::block_type::dimension;
+
+    Communicator& communicator_;
     const Matrix& matrix_;
     Vector consistentDiagonal_;
     
   public:
 
-    DistributedJacobi(const GridView& gridView, const Matrix& matrix)
-      : gridView_(gridView),
+    DistributedJacobi(Communicator& communicator, const Matrix& matrix)
+      : communicator_(communicator),
         matrix_(matrix)
     {
-      Vector diagonal(matrix_.N());
-      for(int i=0; i<diagonal.size(); i++) {
-        for(int j=0; j<GridView::dimension; j++) {
-          diagonal[i][j] = matrix_[i][i][j][j];
+      consistentDiagonal_.resize(matrix_.N());
+      for(int i=0; i<consistentDiagonal_.size(); i++) {
+        for(int j=0; j<blockSize; j++) {
+          consistentDiagonal_[i][j] = matrix_[i][i][j][j];
         }
       }
-      consistentDiagonal_ = diagonal;
-      VectorExchangeAdd<GridView, Vector> datahandle(gridView_, consistentDiagonal_);
-      gridView_.communicate(datahandle, Dune::All_All_Interface, Dune::ForwardCommunication);
+      communicator_.add(consistentDiagonal_);
     }
 
     virtual void pre (Vector& x, Vector& b) {}
 
+    // r is consistent (see DistributedMatrixAdapter), so no exchange is needed
     virtual void apply (Vector& v, const Vector& r)
     {
-      auto rConsistent = r;
-      VectorExchangeAdd<GridView, Vector> datahandle(gridView_, rConsistent);
-      gridView_.communicate(datahandle, Dune::InteriorBorder_InteriorBorder_Interface, Dune::ForwardCommunication);
+      v = r;
       
       for(int i=0; i<matrix_.N(); i++) {
-        for(int j=0; j<GridView::dimension; j++) {
-          v[i][j] = rConsistent[i][j]/consistentDiagonal_[i][j];
+        for(int j=0; j<blockSize; j++) {
+          v[i][j] /= consistentDiagonal_[i][j];
         }
       }
     }
@@ -6,37 +6,40 @@
 
 #include <dune/istl/preconditioner.hh>
 #include <dune/istl/solvercategory.hh>
-#include <dune/elastodynamics/parallel/vectordatahandle.hh>
+#include <dune/elastodynamics/parallel/dofcommunicator.hh>
 
 // implements a wrapper for sequential preconditioners applied to each rank
-// and communicating the necessary values in between
-// currently works for: Richardson, SeqJac (n=1!!!)
+// to the consistent defect, every copy of a shared dof then takes the value of
+// the owning rank (DofCommunicator::makeConsistent), so the output is consistent
+// currently works for: Richardson, SeqJac (n=1!!!) with a consistent diagonal
+// the owner choice is not symmetric, for CG and for SSOR/ILU(0) use
+// HybridPreconditioner
 
 namespace Amg
 { template<class T> struct ConstructionTraits; }
   
-template<class GridView, class P>
+template<class Communicator, class P>
 class DistributedPreconditioner : public Dune::Preconditioner<typename P::domain_type, typename P::range_type> {
     
-  friend struct Amg::ConstructionTraits<DistributedPreconditioner<GridView, P>>;
+  friend struct Amg::ConstructionTraits<DistributedPreconditioner<Communicator, P>>;
   
   using X = typename P::domain_type;
   using Y = typename P::range_type;
     
   private:
 
+    Communicator& communicator_;
     std::shared_ptr<P> preconditioner_;
-    const GridView& gridView_;
     
   public:
 
-    DistributedPreconditioner(const GridView& gridView, P& p)
-      : gridView_(gridView),
+    DistributedPreconditioner(Communicator& communicator, P& p)
+      : communicator_(communicator),
         preconditioner_(stackobject_to_shared_ptr(p))
     {}
 
-    DistributedPreconditioner(const GridView& gridView, const std::shared_ptr<P>& p)
-      : gridView_(gridView),
+    DistributedPreconditioner(Communicator& communicator, const std::shared_ptr<P>& p)
+      : communicator_(communicator),
         preconditioner_(p)
     {}
 
@@ -48,18 +51,16 @@ class DistributedPreconditioner : public Dune::Preconditioner<typename P::domain
     virtual void apply (X& v, const Y& d)
     {
       preconditioner_->apply(v,d); 
-      // communicate values here
-      VectorExchangeAdd<GridView, X> datahandle(gridView_, v);
-      gridView_.communicate(datahandle, Dune::InteriorBorder_InteriorBorder_Interface, Dune::ForwardCommunication);
+      // the owner's values on all copies
+      communicator_.makeConsistent(v);
     }
 
     template<bool forward>
     void apply (X& v, const Y& d)
     {
       preconditioner_->template apply<forward>(v,d);      
-      // comunnicate values here
-      VectorExchangeAdd<GridView, X> datahandle(gridView_, v);
-      gridView_.communicate(datahandle, Dune::InteriorBorder_InteriorBorder_Interface, Dune::ForwardCommunication);
+      // the owner's values on all copies
+      communicator_.makeConsistent(v);
     }
 
     virtual void post (X& x)
@@ -11,9 +11,11 @@ Numerics Environment by Oliver Sander and is modified!
 
 #include <dune/istl/scalarproducts.hh>
 #include <dune/istl/solvercategory.hh>
-#include <dune/elastodynamics/parallel/vectordatahandle.hh>
+#include <dune/elastodynamics/parallel/dofcommunicator.hh>
 
-template<class GridView, class Vector>
+// scalar product for consistent vectors, every shared dof is counted once by
+// its owning rank, so dot and norm need a single allreduce and no exchange
+template<class Communicator, class Vector>
 class DistributedScalarProduct : public Dune::ScalarProduct<Vector> {
     
   using typename Dune::ScalarProduct<Vector>::field_type;
@@ -21,26 +23,35 @@ class DistributedScalarProduct : public Dune::ScalarProduct<Vector> {
     
   private:
     
-    const GridView& gridView_;
+    Communicator& communicator_;
     
   public:
     
-  DistributedScalarProduct(const GridView& gridView)
-    : gridView_(gridView)
+  DistributedScalarProduct(Communicator& communicator)
+    : communicator_(communicator)
   {}
   
+  // rank-local part of dot(x, y)
+  field_type localDot(const Vector& x, const Vector& y) const
+  {
+    field_type result = x.dot(y);
+    for(auto i : communicator_.notOwned())
+      result -= x[i]*y[i];
+    return result;
+  }
+
+  // fused nonblocking reduction of several local dots, see PipelinedCGSolver
+  void startSum(double* values, int n) const
+  { communicator_.startSum(values, n); }
+
+  void finishSum() const
+  { communicator_.finishSum(); }
+
   virtual field_type dot(const Vector& x, const Vector& y) const override
-  { return gridView_.comm().sum(x.dot(y)); }
+  { return communicator_.gridView().comm().sum(localDot(x, y)); }
       
   virtual real_type norm(const Vector& x) const override
-  {
-    auto xConsistent = x;
-    VectorExchangeAdd<GridView, Vector> datahandle(gridView_, xConsistent);
-    gridView_.communicate(datahandle, Dune::InteriorBorder_InteriorBorder_Interface, Dune::ForwardCommunication);
-      
-    auto localNorm2 = x.dot(xConsistent);
-    return std::sqrt(gridView_.comm().sum(localNorm2));
-  }
+  { return std::sqrt(std::abs(dot(x, x))); }
       
   virtual Dune::SolverCategory::Category category() const override
   { return Dune::SolverCategory::sequential; }
@@ -0,0 +1,249 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef GEOMETRIC_MULTIGRID_HH
+#define GEOMETRIC_MULTIGRID_HH
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/shared_ptr.hh>
+#include <dune/grid/common/exceptions.hh>
+#include <dune/istl/matrixindexset.hh>
+#include <dune/istl/matrixmatrix.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+#include <dune/istl/umfpack.hh>
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/elastodynamics/preconditioners/blocksmoothers.hh>
+
+// Geometric multigrid on the refinement hierarchy of the grid (e.g. UGGrid after
+// globalRefine). The matrix belongs to the power<dim>(lagrange<order>()) basis on the
+// leaf view, the coarse operators are Galerkin products P^T A P with the Lagrange
+// prolongation between consecutive levels, so they carry the boundary conditions and
+// work for any operator assembled on the leaf (stiffness, Newmark's M + beta dt^2 K).
+// Rows eliminated by the BoundaryIndexBCAssembler are left out of the prolongation.
+// Symmetric V-cycle with block Jacobi, block Gauss-Seidel or Chebyshev smoothing,
+// UMFPack on level 0.
+template<class Grid, int order, class Matrix, class Vector>
+class GeometricMultigrid : public Dune::Preconditioner<Vector, Vector> {
+
+  private:
+
+    static const int blockSize = Vector::block_type::dimension;
+
+    struct Level {
+      std::shared_ptr<const Matrix> A;
+      std::vector<typename Matrix::block_type> Dinv;
+      double lambdaMax;
+      // prolongation from the next coarser level
+      Matrix P;
+      Vector x, b, r, d;
+    };
+
+    std::vector<Level> levels_;
+    std::unique_ptr<Dune::UMFPack<Matrix>> coarseSolver_;
+
+  public:
+
+    enum class Smoother { jacobi, gaussSeidel, chebyshev };
+
+  private:
+
+    Smoother smoother_;
+    int smoothingSteps_;
+
+    template<class GridView>
+    static auto makeBasis(const GridView& gridView)
+    {
+      using namespace Dune::Functions::BasisFactory;
+      return Dune::Functions::BasisFactory::makeBasis(gridView, power<blockSize>(lagrange<order>()));
+    }
+
+    // interpolation of the coarse shape functions at the fine Lagrange nodes,
+    // the same for every component
+    template<class CoarseBasis, class FineBasis>
+    static Matrix prolongation(const CoarseBasis& coarseBasis, const FineBasis& fineBasis,
+                               const std::vector<bool>& constrained)
+    {
+      std::vector<std::map<std::size_t, double>> rows(fineBasis.size());
+
+      auto fineView = fineBasis.localView();
+      auto coarseView = coarseBasis.localView();
+      std::vector<Dune::FieldVector<double, 1>> values;
+      std::vector<double> coefficients;
+
+      for(const auto& element : elements(fineBasis.gridView())) {
+
+        if(!element.hasFather())
+          DUNE_THROW(Dune::GridError, "GeometricMultigrid needs a uniformly refined grid");
+        const auto father = element.father();
+        const auto geometryInFather = element.geometryInFather();
+        fineView.bind(element);
+        coarseView.bind(father);
+
+        const auto& fineNode = fineView.tree().child(0);
+        const auto& coarseNode = coarseView.tree().child(0);
+        const auto& coarseBasisFunctions = coarseNode.finiteElement().localBasis();
+
+        for(std::size_t j=0; j<coarseNode.size(); j++) {
+          auto f = [&](const auto& x) {
+            coarseBasisFunctions.evaluateFunction(geometryInFather.global(x), values);
+            return values[j];
+          };
+          fineNode.finiteElement().localInterpolation().interpolate(f, coefficients);
+
+          const auto col = coarseView.index(coarseNode.localIndex(j))[0];
+          for(std::size_t i=0; i<fineNode.size(); i++) {
+            const auto row = fineView.index(fineNode.localIndex(i))[0];
+            if(std::abs(coefficients[i]) > 1e-12 and (constrained.empty() or !constrained[row]))
+              rows[row][col] = coefficients[i];
+          }
+        }
+      }
+
+      Dune::MatrixIndexSet pattern(fineBasis.size(), coarseBasis.size());
+      for(std::size_t i=0; i<rows.size(); i++)
+        for(const auto& entry : rows[i])
+          pattern.add(i, entry.first);
+
+      Matrix P;
+      pattern.exportIdx(P);
+      P = 0.0;
+      for(std::size_t i=0; i<rows.size(); i++)
+        for(const auto& entry : rows[i])
+          for(int k=0; k<blockSize; k++)
+            P[i][entry.first][k][k] = entry.second;
+      return P;
+    }
+
+    void initialize(Level& level)
+    {
+      level.Dinv = Dune::Elastodynamics::invertedDiagonal(*level.A);
+      level.lambdaMax = Dune::Elastodynamics::blockJacobiLambdaMax<Vector>(*level.A, level.Dinv);
+      level.x.resize(level.A->N());
+      level.b.resize(level.A->N());
+      level.r.resize(level.A->N());
+      level.d.resize(level.A->N());
+    }
+
+    // P^T A P of the finer level
+    static std::shared_ptr<const Matrix> galerkin(const Level& fine)
+    {
+      Matrix AP;
+      Dune::matMultMat(AP, *fine.A, fine.P);
+      auto Ac = std::make_shared<Matrix>();
+      Dune::transposeMatMultMat(*Ac, fine.P, AP);
+
+      // coarse dofs only supported by constrained fine dofs
+      for(std::size_t i=0; i<Ac->N(); i++)
+        for(int k=0; k<blockSize; k++)
+          if((*Ac)[i][i][k][k] == 0.0)
+            (*Ac)[i][i][k][k] = 1.0;
+      return Ac;
+    }
+
+    // for Chebyshev the number of smoothing steps is the polynomial degree,
+    // it damps [0.3, 1.1]*lambda_max of D^-1 A
+    void smooth(Level& level, bool forward)
+    {
+      if(smoother_ == Smoother::chebyshev) {
+        const double upper = 1.1*level.lambdaMax;
+        Dune::Elastodynamics::blockChebyshev(*level.A, level.Dinv, level.x, level.b, 0.3*upper, upper, smoothingSteps_, false, level.r, level.d);
+        return;
+      }
+      for(int s=0; s<smoothingSteps_; s++) {
+        if(smoother_ == Smoother::gaussSeidel)
+          Dune::Elastodynamics::blockGaussSeidel(*level.A, level.Dinv, level.x, level.b, forward);
+        else
+          Dune::Elastodynamics::blockJacobi(*level.A, level.Dinv, level.x, level.b, 4.0/3.0/level.lambdaMax, level.r);
+      }
+    }
+
+    void cycle(std::size_t l)
+    {
+      auto& level = levels_[l];
+      if(l+1 == levels_.size()) {
+        Dune::InverseOperatorResult res;
+        level.r = level.b;
+        coarseSolver_->apply(level.x, level.r, res);
+        return;
+      }
+
+      auto& coarse = levels_[l+1];
+      smooth(level, true);
+      level.r = level.b;
+      level.A->mmv(level.x, level.r);
+      level.P.mtv(level.r, coarse.b);
+      coarse.x = 0.0;
+      cycle(l+1);
+      level.P.umv(coarse.x, level.x);
+      smooth(level, false);
+    }
+
+  public:
+
+    // the matrix has to outlive the preconditioner
+    GeometricMultigrid(const Grid& grid, const Matrix& matrix,
+                       Smoother smoother = Smoother::gaussSeidel, int smoothingSteps = 2)
+      : smoother_(smoother),
+        smoothingSteps_(smoothingSteps)
+    {
+      const int maxLevel = grid.maxLevel();
+      levels_.resize(maxLevel+1);
+      levels_[0].A = Dune::stackobject_to_shared_ptr(matrix);
+
+      if(maxLevel > 0) {
+        // identity rows of eliminated dofs
+        std::vector<bool> constrained(matrix.N(), true);
+        for(std::size_t i=0; i<matrix.N(); i++)
+          for(auto col = matrix[i].begin(); col != matrix[i].end(); ++col)
+            if(col.index() != i and (*col).frobenius_norm2() > 0.0)
+              constrained[i] = false;
+
+        // bases on the levels maxLevel-1, ..., 0
+        using LevelBasis = decltype(makeBasis(grid.levelGridView(0)));
+        std::vector<LevelBasis> bases;
+        for(int l=maxLevel-1; l>=0; l--)
+          bases.push_back(makeBasis(grid.levelGridView(l)));
+
+        levels_[0].P = prolongation(bases[0], makeBasis(grid.leafGridView()), constrained);
+        for(int l=1; l<=maxLevel; l++) {
+          levels_[l].A = galerkin(levels_[l-1]);
+          if(l < maxLevel)
+            levels_[l].P = prolongation(bases[l], bases[l-1], {});
+        }
+      }
+
+      for(auto& level : levels_)
+        initialize(level);
+      coarseSolver_ = std::make_unique<Dune::UMFPack<Matrix>>(*levels_.back().A);
+    }
+
+    virtual void pre (Vector& x, Vector& b) {}
+
+    // one V-cycle
+    virtual void apply (Vector& v, const Vector& d)
+    {
+      levels_[0].b = d;
+      levels_[0].x = 0.0;
+      cycle(0);
+      v = levels_[0].x;
+    }
+
+    virtual void post (Vector& x) {}
+
+    int levels() const
+    { return levels_.size(); }
+
+    virtual Dune::SolverCategory::Category category() const
+    { return Dune::SolverCategory::sequential; }
+
+};
+
+#endif
@@ -0,0 +1,105 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef HYBRID_PRECONDITIONER_HH
+#define HYBRID_PRECONDITIONER_HH
+
+#include <cmath>
+#include <functional>
+#include <memory>
+
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvercategory.hh>
+#include <dune/elastodynamics/parallel/dofcommunicator.hh>
+
+// Hybrid block-SSOR/ILU(0): every rank applies a sequential preconditioner
+// (SSOR, ILU(0) or any other one given by a factory, e.g. RigidBodyAMG) to its
+// local matrix, whose nodal blocks of the shared dofs are replaced by the consistent
+// (summed) ones. The local results are combined as sum_k R_k^T W_k M_k^-1 W_k R_k
+// with W_k = 1/sqrt(number of ranks sharing the dof), which keeps the
+// preconditioner symmetric for CG and the output consistent.
+template<class Communicator, class Matrix, class Vector>
+class HybridPreconditioner : public Dune::Preconditioner<Vector, Vector> {
+
+  private:
+
+    static const int blockSize = Vector::block_type::dimension;
+
+    Communicator& communicator_;
+    Matrix localMatrix_;
+    Vector weight_, rWeighted_;
+    std::unique_ptr<Dune::Preconditioner<Vector, Vector>> local_;
+
+  public:
+
+    enum class LocalSolver { ssor, ilu0 };
+
+    using Factory = std::function<std::unique_ptr<Dune::Preconditioner<Vector, Vector>>(const Matrix&)>;
+
+    HybridPreconditioner(Communicator& communicator, const Matrix& matrix,
+                         LocalSolver solver = LocalSolver::ssor,
+                         int iterations = 1, double relaxation = 1.0)
+      : HybridPreconditioner(communicator, matrix, [&](const Matrix& localMatrix)
+          -> std::unique_ptr<Dune::Preconditioner<Vector, Vector>> {
+            if(solver == LocalSolver::ssor)
+              return std::make_unique<Dune::SeqSSOR<Matrix, Vector, Vector>>(localMatrix, iterations, relaxation);
+            return std::make_unique<Dune::SeqILU<Matrix, Vector, Vector>>(localMatrix, relaxation);
+          })
+    {}
+
+    // any local preconditioner, built by factory from the local matrix
+    HybridPreconditioner(Communicator& communicator, const Matrix& matrix, const Factory& factory)
+      : communicator_(communicator),
+        localMatrix_(matrix),
+        weight_(matrix.N()),
+        rWeighted_(matrix.N())
+    {
+      // consistent nodal blocks
+      Vector column(matrix.N());
+      for(int j=0; j<blockSize; j++) {
+        for(std::size_t i=0; i<matrix.N(); i++)
+          for(int k=0; k<blockSize; k++)
+            column[i][k] = matrix[i][i][k][j];
+        communicator_.add(column);
+        for(std::size_t i=0; i<matrix.N(); i++)
+          for(int k=0; k<blockSize; k++)
+            localMatrix_[i][i][k][j] = column[i][k];
+      }
+
+      // multiplicity of the dofs
+      weight_ = 1.0;
+      communicator_.add(weight_);
+      for(std::size_t i=0; i<weight_.size(); i++)
+        for(int k=0; k<blockSize; k++)
+          weight_[i][k] = 1.0/std::sqrt(weight_[i][k]);
+
+      local_ = factory(localMatrix_);
+    }
+
+    virtual void pre (Vector& x, Vector& b) {}
+
+    virtual void apply (Vector& v, const Vector& r)
+    {
+      for(std::size_t i=0; i<r.size(); i++)
+        for(int k=0; k<blockSize; k++)
+          rWeighted_[i][k] = weight_[i][k]*r[i][k];
+
+      v = 0.0;
+      local_->apply(v, rWeighted_);
+
+      for(std::size_t i=0; i<v.size(); i++)
+        for(int k=0; k<blockSize; k++)
+          v[i][k] *= weight_[i][k];
+
+      communicator_.add(v);
+    }
+
+    virtual void post (Vector& x) {}
+
+    virtual Dune::SolverCategory::Category category() const
+    { return Dune::SolverCategory::sequential; }
+
+};
+
+#endif
@@ -0,0 +1,396 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef RIGID_BODY_AMG_HH
+#define RIGID_BODY_AMG_HH
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/shared_ptr.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/matrixmatrix.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+#include <dune/istl/umfpack.hh>
+#include <dune/functions/functionspacebases/interpolate.hh>
+#include <dune/elastodynamics/preconditioners/blocksmoothers.hh>
+#include <dune/elastodynamics/preconditioners/hybridpreconditioner.hh>
+
+// number of rigid body modes: translations and rotations
+template<int dim>
+constexpr int rigidBodyModeCount = dim*(dim+1)/2;
+
+// rigid body modes of a power<dim>(lagrange<p>()) basis, evaluated at the
+// Lagrange nodes relative to their centroid, one dim x modes block per node
+template<class Basis>
+auto rigidBodyModes(const Basis& basis)
+{
+  const int dim = Basis::GridView::dimension;
+  const int modes = rigidBodyModeCount<dim>;
+  using Coordinate = Dune::FieldVector<double, dim>;
+
+  Dune::BlockVector<Coordinate> coordinates(basis.size());
+  Dune::Functions::interpolate(basis, coordinates, [](const Coordinate& x) { return x; });
+
+  Coordinate center(0.0);
+  for(const auto& x : coordinates)
+    center += x;
+  center /= coordinates.size();
+
+  std::vector<Dune::FieldMatrix<double, dim, modes>> B(coordinates.size());
+  for(std::size_t i=0; i<coordinates.size(); i++) {
+    auto x = coordinates[i];
+    x -= center;
+    B[i] = 0.0;
+    for(int d=0; d<dim; d++)
+      B[i][d][d] = 1.0;
+    if constexpr (dim == 2) {
+      B[i][0][2] = -x[1];
+      B[i][1][2] =  x[0];
+    }
+    if constexpr (dim == 3) {
+      B[i][1][3] = -x[2]; B[i][2][3] =  x[1];
+      B[i][0][4] =  x[2]; B[i][2][4] = -x[0];
+      B[i][0][5] = -x[1]; B[i][1][5] =  x[0];
+    }
+  }
+  return B;
+}
+
+// Smoothed aggregation AMG [Vanek, Mandel, Brezina] for the block elasticity operators.
+// The tentative prolongator interpolates the rigid body modes exactly on every
+// aggregate (local QR), so rotations are resolved on the coarse levels, which
+// is what keeps the iteration counts independent of the mesh size. Coarse
+// levels carry one modes x modes block per aggregate. Rows without couplings
+// (eliminated Dirichlet dofs) are left out of the aggregates.
+// Symmetric V-cycle: forward block Gauss-Seidel before, backward after the
+// coarse correction, UMFPack on the coarsest level.
+template<class Matrix, class Vector>
+class RigidBodyAMG : public Dune::Preconditioner<Vector, Vector> {
+
+  public:
+
+    static const int blockSize = Vector::block_type::dimension;
+    static const int modes = rigidBodyModeCount<blockSize>;
+
+    using NullSpace = std::vector<Dune::FieldMatrix<double, blockSize, modes>>;
+
+  private:
+
+    using CoarseMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, modes, modes>>;
+    using CoarseVector = Dune::BlockVector<Dune::FieldVector<double, modes>>;
+
+    template<class M, class V>
+    struct Level {
+      std::shared_ptr<const M> A;
+      std::vector<typename M::block_type> Dinv;
+      // prolongation from the next coarser level
+      Dune::BCRSMatrix<Dune::FieldMatrix<double, M::block_type::rows, modes>> P;
+      V x, b, r;
+    };
+
+    Level<Matrix, Vector> fine_;
+    std::vector<Level<CoarseMatrix, CoarseVector>> coarse_;
+
+    std::unique_ptr<Dune::UMFPack<Matrix>> fineSolver_;
+    std::unique_ptr<Dune::UMFPack<CoarseMatrix>> coarseSolver_;
+
+    int smoothingSteps_;
+
+    template<class M, class V>
+    static void initialize(Level<M, V>& level)
+    {
+      level.Dinv = Dune::Elastodynamics::invertedDiagonal(*level.A);
+      level.x.resize(level.A->N());
+      level.b.resize(level.A->N());
+      level.r.resize(level.A->N());
+    }
+
+    // builds P and the coarse matrix and null space, false if A cannot be coarsened
+    template<class M, class V, class B>
+    static bool coarsen(Level<M, V>& level, const B& nullspace, double theta,
+                        std::shared_ptr<const CoarseMatrix>& coarseMatrix,
+                        std::vector<Dune::FieldMatrix<double, modes, modes>>& coarseNullspace)
+    {
+      const auto& A = *level.A;
+      const int rows = M::block_type::rows;
+      const std::size_t n = A.N();
+
+      // strength of connection, rows without off-diagonal entries are isolated
+      std::vector<double> diagonal(n);
+      std::vector<bool> isolated(n, true);
+      for(std::size_t i=0; i<n; i++) {
+        diagonal[i] = A[i][i].frobenius_norm();
+        for(auto col = A[i].begin(); col != A[i].end(); ++col)
+          if(col.index() != i and (*col).frobenius_norm2() > 0.0)
+            isolated[i] = false;
+      }
+
+      std::vector<std::vector<std::size_t>> strong(n);
+      for(std::size_t i=0; i<n; i++) {
+        if(isolated[i])
+          continue;
+        for(auto col = A[i].begin(); col != A[i].end(); ++col) {
+          const auto j = col.index();
+          if(j != i and !isolated[j] and (*col).frobenius_norm() > theta*std::sqrt(diagonal[i]*diagonal[j]))
+            strong[i].push_back(j);
+        }
+      }
+
+      // aggregation: roots with untouched neighborhoods, then attach the rest
+      std::vector<int> aggregate(n, -1);
+      int aggregates = 0;
+      for(std::size_t i=0; i<n; i++) {
+        if(strong[i].empty() or aggregate[i] >= 0)
+          continue;
+        if(std::any_of(strong[i].begin(), strong[i].end(), [&](auto j) { return aggregate[j] >= 0; }))
+          continue;
+        aggregate[i] = aggregates;
+        for(auto j : strong[i])
+          aggregate[j] = aggregates;
+        aggregates++;
+      }
+
+      std::vector<int> attached(aggregate);
+      for(std::size_t i=0; i<n; i++) {
+        if(aggregate[i] >= 0)
+          continue;
+        for(auto j : strong[i])
+          if(aggregate[j] >= 0) {
+            attached[i] = aggregate[j];
+            break;
+          }
+      }
+      aggregate = attached;
+
+      for(std::size_t i=0; i<n; i++) {
+        if(strong[i].empty() or aggregate[i] >= 0)
+          continue;
+        aggregate[i] = aggregates;
+        for(auto j : strong[i])
+          if(aggregate[j] < 0)
+            aggregate[j] = aggregates;
+        aggregates++;
+      }
+
+      if(aggregates == 0 or aggregates*modes >= 0.8*n*rows)
+        return false;
+
+      // tentative prolongator, QR of the null space restricted to each aggregate
+      using Prolongation = Dune::BCRSMatrix<Dune::FieldMatrix<double, rows, modes>>;
+      Prolongation tentative;
+      tentative.setBuildMode(Prolongation::random);
+      tentative.setSize(n, aggregates, n);
+      for(std::size_t i=0; i<n; i++)
+        tentative.setrowsize(i, aggregate[i] >= 0 ? 1 : 0);
+      tentative.endrowsizes();
+      for(std::size_t i=0; i<n; i++)
+        if(aggregate[i] >= 0)
+          tentative.addindex(i, aggregate[i]);
+      tentative.endindices();
+
+      std::vector<std::vector<std::size_t>> members(aggregates);
+      for(std::size_t i=0; i<n; i++)
+        if(aggregate[i] >= 0)
+          members[aggregate[i]].push_back(i);
+
+      coarseNullspace.clear();
+      coarseNullspace.resize(aggregates);
+      for(int a=0; a<aggregates; a++) {
+        auto& R = coarseNullspace[a];
+        std::vector<typename B::value_type> Q;
+        for(auto i : members[a])
+          Q.push_back(nullspace[i]);
+
+        // modified Gram-Schmidt, dependent columns are dropped
+        for(int c=0; c<modes; c++) {
+          double norm0 = 0.0;
+          for(const auto& q : Q)
+            for(int r=0; r<rows; r++)
+              norm0 += q[r][c]*q[r][c];
+
+          for(int k=0; k<c; k++) {
+            double s = 0.0;
+            for(const auto& q : Q)
+              for(int r=0; r<rows; r++)
+                s += q[r][k]*q[r][c];
+            R[k][c] = s;
+            for(auto& q : Q)
+              for(int r=0; r<rows; r++)
+                q[r][c] -= s*q[r][k];
+          }
+
+          double norm = 0.0;
+          for(const auto& q : Q)
+            for(int r=0; r<rows; r++)
+              norm += q[r][c]*q[r][c];
+          norm = std::sqrt(norm);
+
+          const double scale = norm > 1e-10*std::sqrt(norm0) ? 1.0/norm : 0.0;
+          R[c][c] = scale > 0.0 ? norm : 0.0;
+          for(auto& q : Q)
+            for(int r=0; r<rows; r++)
+              q[r][c] *= scale;
+        }
+
+        for(std::size_t m=0; m<members[a].size(); m++)
+          tentative[members[a][m]][a] = Q[m];
+      }
+
+      // smoothed prolongator P = (I - omega D^-1 A) P_tent
+      const double omega = 4.0/3.0/Dune::Elastodynamics::blockJacobiLambdaMax<V>(A, level.Dinv);
+      Dune::matMultMat(level.P, A, tentative);
+      for(std::size_t i=0; i<n; i++) {
+        for(auto col = level.P[i].begin(); col != level.P[i].end(); ++col) {
+          (*col).leftmultiply(level.Dinv[i]);
+          *col *= -omega;
+        }
+        if(aggregate[i] >= 0)
+          level.P[i][aggregate[i]] += tentative[i][aggregate[i]];
+      }
+
+      // Galerkin product P^T A P
+      Prolongation AP;
+      Dune::matMultMat(AP, A, level.P);
+      auto Ac = std::make_shared<CoarseMatrix>();
+      Dune::transposeMatMultMat(*Ac, level.P, AP);
+
+      // dropped null space columns leave empty coarse dofs
+      for(int a=0; a<aggregates; a++)
+        for(int k=0; k<modes; k++)
+          if(coarseNullspace[a][k][k] == 0.0)
+            (*Ac)[a][a][k][k] = 1.0;
+
+      coarseMatrix = Ac;
+      return true;
+    }
+
+    void cycle(std::size_t l)
+    {
+      auto& level = coarse_[l];
+      if(l+1 == coarse_.size()) {
+        Dune::InverseOperatorResult res;
+        level.r = level.b;
+        coarseSolver_->apply(level.x, level.r, res);
+        return;
+      }
+
+      auto& next = coarse_[l+1];
+      for(int s=0; s<smoothingSteps_; s++)
+        Dune::Elastodynamics::blockGaussSeidel(*level.A, level.Dinv, level.x, level.b, true);
+      level.r = level.b;
+      level.A->mmv(level.x, level.r);
+      level.P.mtv(level.r, next.b);
+      next.x = 0.0;
+      cycle(l+1);
+      level.P.umv(next.x, level.x);
+      for(int s=0; s<smoothingSteps_; s++)
+        Dune::Elastodynamics::blockGaussSeidel(*level.A, level.Dinv, level.x, level.b, false);
+    }
+
+  public:
+
+    // the matrix has to outlive the preconditioner
+    RigidBodyAMG(const Matrix& matrix, const NullSpace& nullspace,
+                 int maxLevels = 10, int coarseSize = 500, double theta = 0.08,
+                 int smoothingSteps = 1, int verbosity = 0)
+      : smoothingSteps_(smoothingSteps)
+    {
+      fine_.A = Dune::stackobject_to_shared_ptr(matrix);
+      initialize(fine_);
+
+      std::shared_ptr<const CoarseMatrix> Ac;
+      std::vector<Dune::FieldMatrix<double, modes, modes>> Bc;
+      if(matrix.N()*blockSize <= std::size_t(coarseSize) or maxLevels < 2
+         or !coarsen(fine_, nullspace, theta, Ac, Bc)) {
+        fineSolver_ = std::make_unique<Dune::UMFPack<Matrix>>(matrix);
+        return;
+      }
+
+      coarse_.emplace_back();
+      coarse_.back().A = Ac;
+      initialize(coarse_.back());
+
+      while(int(coarse_.size())+1 < maxLevels and Ac->N()*modes > std::size_t(coarseSize)) {
+        auto& level = coarse_.back();
+        auto B = Bc;
+        if(!coarsen(level, B, theta, Ac, Bc))
+          break;
+        coarse_.emplace_back();
+        coarse_.back().A = Ac;
+        initialize(coarse_.back());
+      }
+      coarseSolver_ = std::make_unique<Dune::UMFPack<CoarseMatrix>>(*coarse_.back().A);
+
+      if(verbosity > 0) {
+        std::cout << "RigidBodyAMG: level 0 " << matrix.N()*blockSize << " dofs";
+        for(std::size_t l=0; l<coarse_.size(); l++)
+          std::cout << ", level " << l+1 << " " << coarse_[l].A->N()*modes << " dofs";
+        std::cout << std::endl;
+      }
+    }
+
+    virtual void pre (Vector& x, Vector& b) {}
+
+    // one V-cycle
+    virtual void apply (Vector& v, const Vector& d)
+    {
+      if(fineSolver_) {
+        Dune::InverseOperatorResult res;
+        fine_.r = d;
+        fineSolver_->apply(v, fine_.r, res);
+        return;
+      }
+
+      v = 0.0;
+      for(int s=0; s<smoothingSteps_; s++)
+        Dune::Elastodynamics::blockGaussSeidel(*fine_.A, fine_.Dinv, v, d, true);
+      fine_.r = d;
+      fine_.A->mmv(v, fine_.r);
+      fine_.P.mtv(fine_.r, coarse_[0].b);
+      coarse_[0].x = 0.0;
+      cycle(0);
+      fine_.P.umv(coarse_[0].x, v);
+      for(int s=0; s<smoothingSteps_; s++)
+        Dune::Elastodynamics::blockGaussSeidel(*fine_.A, fine_.Dinv, v, d, false);
+    }
+
+    virtual void post (Vector& x) {}
+
+    // number of levels including the finest
+    int levels() const
+    { return coarse_.size()+1; }
+
+    virtual Dune::SolverCategory::Category category() const
+    { return Dune::SolverCategory::sequential; }
+
+};
+
+// Distributed variant: every rank runs the AMG on its local matrix with consistent
+// nodal blocks (aggregates do not cross rank boundaries), the local cycles are
+// combined like in HybridPreconditioner
+template<class Communicator, class Matrix, class Vector>
+class DistributedRigidBodyAMG : public HybridPreconditioner<Communicator, Matrix, Vector> {
+
+  using AMG = RigidBodyAMG<Matrix, Vector>;
+
+  public:
+
+    DistributedRigidBodyAMG(Communicator& communicator, const Matrix& matrix,
+                            const typename AMG::NullSpace& nullspace,
+                            int maxLevels = 10, int coarseSize = 500, double theta = 0.08)
+      : HybridPreconditioner<Communicator, Matrix, Vector>(communicator, matrix,
+          [&](const Matrix& localMatrix) {
+            return std::make_unique<AMG>(localMatrix, nullspace, maxLevels, coarseSize, theta);
+          })
+    {}
+};
+
+#endif
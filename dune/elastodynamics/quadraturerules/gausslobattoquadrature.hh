@@ -0,0 +1,75 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef GAUSS_LOBATTO_QUADRATURE_HH
+#define GAUSS_LOBATTO_QUADRATURE_HH
+
+#include <cmath>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/geometry/quadraturerules.hh>
+#include <dune/geometry/type.hh>
+
+// Gauss-Lobatto-Legendre points and weights on [0,1], the n-1 inner points are
+// the roots of P'_{n-1}, found by Newton iteration from the Chebyshev-Lobatto points
+template<class ct>
+void gaussLobattoLegendre(int n, std::vector<ct>& points, std::vector<ct>& weights)
+{
+  const int N = n-1;
+  points.resize(n);
+  weights.resize(n);
+  for(int i=0; i<n; i++) {
+    double x = -std::cos(std::acos(-1.0)*i/N), xOld = 2.0;
+    double P = 1.0, PPrev = 1.0;
+    for(int it=0; it<100 and std::abs(x-xOld) > 1e-15; it++) {
+      xOld = x;
+      double P0 = 1.0, P1 = x;
+      for(int k=2; k<=N; k++) {
+        const double P2 = ((2*k-1)*x*P1 - (k-1)*P0)/k;
+        P0 = P1;
+        P1 = P2;
+      }
+      P = P1;
+      PPrev = P0;
+      x = xOld - (x*P - PPrev)/((N+1)*P);
+    }
+    points[i] = 0.5*(x+1.0);
+    weights[i] = 1.0/(N*(N+1)*P*P);
+  }
+}
+
+// tensor product Gauss-Lobatto-Legendre rule on the cube with n points per
+// direction (lexicographic, x runs fastest), exact for polynomials of degree 2n-3
+template<class ct, int dim>
+class GaussLobattoQuadratureRule : public Dune::QuadratureRule<ct, dim> {
+
+  using Base = Dune::QuadratureRule<ct, dim>;
+  using QuadPoint = Dune::QuadraturePoint<ct, dim>;
+
+  public:
+
+    GaussLobattoQuadratureRule(int n) : Base(Dune::GeometryTypes::cube(dim), 2*n-3) {
+
+      std::vector<ct> points, weights;
+      gaussLobattoLegendre(n, points, weights);
+
+      int size = 1;
+      for(int k=0; k<dim; k++)
+        size *= n;
+
+      this->reserve(size);
+      for(int i=0; i<size; i++) {
+        Dune::FieldVector<ct, dim> position;
+        ct weight = 1.0;
+        for(int k=0, j=i; k<dim; k++, j/=n) {
+          position[k] = points[j%n];
+          weight *= weights[j%n];
+        }
+        this->push_back(QuadPoint(position, weight));
+      }
+    }
+
+};
+
+#endif
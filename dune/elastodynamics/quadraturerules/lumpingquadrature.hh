@@ -13,8 +13,15 @@ Availability: https://git.imp.fu-berlin.de/agnumpde/dune-fufem/-/blob/master/dun
 #ifndef LUMPINGQUADRATURERULE_HH
 #define LUMPINGQUADRATURERULE_HH
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+#include <dune/common/exceptions.hh>
 #include <dune/geometry/referenceelements.hh>
 #include <dune/geometry/quadraturerules.hh>
+#include <dune/geometry/typeindex.hh>
+#include <dune/elastodynamics/quadraturerules/gausslobattoquadrature.hh>
 
 template<class ct, int dim>
 class LumpingQuadratureRule : public Dune::QuadratureRule<ct, dim> {
@@ -38,4 +45,53 @@ class LumpingQuadratureRule : public Dune::QuadratureRule<ct, dim> {
     
 };
 
+// Process-wide table of lumping rules per (GeometryType, order of the lumped
+// basis), each rule is built once and shared by all elements and threads:
+// - order 1: the vertex rule above
+// - cubes of order p: Gauss-Lobatto-Legendre with p+1 points per direction, the
+//   quadrature points are the nodes for p <= 2 and for GLL node bases, there the
+//   mass matrix is diagonal (spectral elements)
+// Simplices of higher order have no nodal rule with positive weights, use the
+// HRZ lumping there.
+// The table has a fixed slot per key, a lookup after the first one is the
+// acquire load of the slot's once_flag and takes no lock.
+template<class ct, int dim>
+class LumpingQuadratureRules {
+
+  using Rule = Dune::QuadratureRule<ct, dim>;
+
+  static const int maxOrder = 16;
+
+  struct Entry {
+    std::once_flag flag;
+    std::unique_ptr<Rule> rule;
+  };
+
+  static Entry& entry(std::size_t index, int order) {
+    static Entry table[Dune::LocalGeometryTypeIndex::size(dim)][maxOrder+1];
+    return table[index][order];
+  }
+
+  public:
+
+    static const Rule& rule(const Dune::GeometryType& gt, int order = 1) {
+
+      if(order > maxOrder)
+        DUNE_THROW(Dune::NotImplemented, "no lumping rule of order " << order << " > " << maxOrder);
+      order = std::max(order, 1);
+
+      auto& slot = entry(Dune::LocalGeometryTypeIndex::index(gt), order);
+      std::call_once(slot.flag, [&] {
+        if(order == 1)
+          slot.rule = std::make_unique<LumpingQuadratureRule<ct, dim>>(gt);
+        else if(gt.isCube())
+          slot.rule = std::make_unique<GaussLobattoQuadratureRule<ct, dim>>(order+1);
+        else
+          DUNE_THROW(Dune::NotImplemented, "no lumping rule of order " << order << " for " << gt);
+      });
+      return *slot.rule;
+    }
+
+};
+
 #endif
@@ -0,0 +1,147 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef PIPELINED_CG_HH
+#define PIPELINED_CG_HH
+
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include <dune/common/timer.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solver.hh>
+#include <dune/istl/solvercategory.hh>
+
+namespace Dune::Elastodynamics {
+
+  // Pipelined preconditioned CG [Ghysels, Vanroose]
+  // -----------------------------------------------
+  // Both dot products of an iteration are fused into a single nonblocking
+  // reduction, which runs while the preconditioner and the SpMV are applied.
+  // The scalar product has to provide localDot, startSum and finishSum
+  // (DistributedScalarProduct does). Convergence is measured in the
+  // preconditioned residual norm sqrt(r^T M^-1 r), so no extra reduction is needed.
+  template<class Vector, class ScalarProduct>
+  class PipelinedCGSolver : public Dune::InverseOperator<Vector, Vector> {
+
+    using field_type = typename Vector::field_type;
+
+    private:
+
+      Dune::LinearOperator<Vector, Vector>& operator_;
+      Dune::Preconditioner<Vector, Vector>& preconditioner_;
+      const ScalarProduct& scalarProduct_;
+      double reduction_;
+      int maxIterations_, verbose_;
+
+    public:
+
+      PipelinedCGSolver(Dune::LinearOperator<Vector, Vector>& op,
+                        const ScalarProduct& scalarProduct,
+                        Dune::Preconditioner<Vector, Vector>& preconditioner,
+                        double reduction, int maxIterations, int verbose)
+        : operator_(op)
+        , preconditioner_(preconditioner)
+        , scalarProduct_(scalarProduct)
+        , reduction_(reduction)
+        , maxIterations_(maxIterations)
+        , verbose_(verbose)
+      {}
+
+      virtual void apply(Vector& x, Vector& b, Dune::InverseOperatorResult& res) override
+      {
+        apply(x, b, reduction_, res);
+      }
+
+      virtual void apply(Vector& x, Vector& b, double reduction, Dune::InverseOperatorResult& res) override
+      {
+        Dune::Timer watch;
+        res.clear();
+
+        Vector r(b), u(b), w(b), m(b), n(b), z(b), q(b), s(b), p(b);
+        z = 0.0; q = 0.0; s = 0.0; p = 0.0;
+
+        preconditioner_.pre(x, b);
+
+        // r = b - Ax, u = M^-1 r, w = Au
+        operator_.applyscaleadd(-1.0, x, r);
+        u = 0.0;
+        preconditioner_.apply(u, r);
+        operator_.apply(u, w);
+
+        std::array<double, 2> sums;
+        double gamma, gammaOld = 0.0, alpha = 0.0, def0 = 0.0, def = 0.0;
+
+        int i = 0;
+        for(; i<=maxIterations_; i++) {
+
+          // gamma = (r,u), delta = (w,u) in one reduction ...
+          sums[0] = scalarProduct_.localDot(r, u);
+          sums[1] = scalarProduct_.localDot(w, u);
+          scalarProduct_.startSum(sums.data(), 2);
+
+          // ... hidden behind m = M^-1 w and n = Am
+          m = 0.0;
+          preconditioner_.apply(m, w);
+          operator_.apply(m, n);
+
+          scalarProduct_.finishSum();
+          gamma = sums[0];
+          const double delta = sums[1];
+
+          def = std::sqrt(std::abs(gamma));
+          if(i == 0)
+            def0 = def;
+
+          if(verbose_ > 1)
+            std::cout << std::setw(5) << i << std::setw(15) << def << std::endl;
+
+          if(def <= reduction*def0 or def == 0.0) {
+            res.converged = true;
+            break;
+          }
+          if(i == maxIterations_)
+            break;
+
+          double beta = 0.0;
+          if(i > 0) {
+            beta = gamma/gammaOld;
+            alpha = gamma/(delta - beta*gamma/alpha);
+          } else {
+            alpha = gamma/delta;
+          }
+          gammaOld = gamma;
+
+          z *= beta; z += n;
+          q *= beta; q += m;
+          s *= beta; s += w;
+          p *= beta; p += u;
+
+          x.axpy(alpha, p);
+          r.axpy(-alpha, s);
+          u.axpy(-alpha, q);
+          w.axpy(-alpha, z);
+        }
+
+        preconditioner_.post(x);
+
+        res.iterations = i;
+        res.reduction = def0 > 0.0 ? def/def0 : 0.0;
+        res.conv_rate = i > 0 ? std::pow(res.reduction, 1.0/i) : 0.0;
+        res.elapsed = watch.elapsed();
+
+        if(verbose_ > 0)
+          std::cout << "=== PipelinedCGSolver: " << (res.converged ? "converged" : "not converged")
+                    << ", iterations " << res.iterations << ", reduction " << res.reduction
+                    << ", time " << res.elapsed << std::endl;
+      }
+
+      virtual Dune::SolverCategory::Category category() const override
+      { return Dune::SolverCategory::sequential; }
+  };
+}
+
+#endif
@@ -5,15 +5,39 @@
 #define COEFFICIENTS_HH
 
 #include <math.h>
+#include <cmath>
+#include <vector>
 
 #include <dune/istl/matrix.hh>
 #include <dune/istl/bvector.hh>
 
+#include "tableaux.hh"
+
 using CoeffMatrix = Dune::Matrix<Dune::FieldMatrix<double, 1, 1>>;
 using CoeffVector = Dune::BlockVector<Dune::FieldVector<double, 1>>;
 
 namespace Dune {
 
+  // runtime copies of the compile-time tableaux
+  template <int s>
+  CoeffMatrix coeffMatrix(const TableauMatrix<s>& tableau)
+  {
+    CoeffMatrix A(s, s);
+    for(int i=0; i<s; i++)
+      for(int j=0; j<s; j++)
+        A[i][j] = tableau[i][j];
+    return A;
+  }
+
+  template <int s>
+  CoeffVector coeffVector(const TableauVector<s>& tableau)
+  {
+    CoeffVector v(s);
+    for(int i=0; i<s; i++)
+      v[i] = tableau[i];
+    return v;
+  }
+
   // Runge-Kutta-Nyström coefficients
   // --------------------------------
   class RKNCoefficients {
@@ -51,45 +75,69 @@ namespace Dune {
   // -------------------------------------
   RKNCoefficients RKN4()
   {
-	
-    static CoeffMatrix A(3, 3);
-    A[0][0] = 0.0; 	   A[0][1] = 0.0; A[0][2] = 0.0;
-	A[1][0] = 1.0/8.0; A[1][1] = 0.0; A[1][2] = 0.0;
-	A[2][0] = 0.0;	   A[2][1] = 0.5; A[2][2] = 0.0;
-		
-	static CoeffVector b_bar(3);	
-	b_bar[0] = 1.0/6.0; b_bar[1] = 1.0/3.0; b_bar[2] = 0.0;
-	
-	static CoeffVector b(3);
-	b[0] = 1.0/6.0; b[1] = 4.0/6.0; b[2] = 1.0/6.0;
-					
-    static CoeffVector c(3);					   	      		
-	c[0] = 0.0; c[1] = 0.5; c[2] = 1.0;
-	  
-	return RKNCoefficients(3, 4, A, b, b_bar, c);			
+    using T = RKN4Tableau;
+    static CoeffMatrix A     = coeffMatrix<T::stages>(T::A);
+    static CoeffVector b_bar = coeffVector<T::stages>(T::b_bar);
+    static CoeffVector b     = coeffVector<T::stages>(T::b);
+    static CoeffVector c     = coeffVector<T::stages>(T::c);
+
+    return RKNCoefficients(T::stages, T::order, A, b, b_bar, c);
   }
 
   // Runge-Kutta-Nyström method of order 5
-  // ------------------------------------- 
+  // -------------------------------------
   RKNCoefficients RKN5()
   {
-    	
-    static CoeffMatrix A(4,4);
-	A[0][0] = 0.0; 	     A[0][1] = 0.0; 	  A[0][2] = 0.0; 	  A[0][3] = 0.0;
-	A[1][0] = 1.0/50.0;  A[1][1] = 0.0; 	  A[1][2] = 0.0; 	  A[1][3] = 0.0;
-	A[2][0] = -1.0/27.0; A[2][1] = 7.0/27.0;  A[2][2] = 0.0; 	  A[2][3] = 0.0;
-	A[3][0] = 3.0/10.0;  A[3][1] = -2.0/35.0; A[3][2] = 9.0/35.0; A[3][3] = 0.0;
+    using T = RKN5Tableau;
+    static CoeffMatrix A     = coeffMatrix<T::stages>(T::A);
+    static CoeffVector b_bar = coeffVector<T::stages>(T::b_bar);
+    static CoeffVector b     = coeffVector<T::stages>(T::b);
+    static CoeffVector c     = coeffVector<T::stages>(T::c);
+
+    return RKNCoefficients(T::stages, T::order, A, b, b_bar, c);
+  }
+
+  // Stability interval of an explicit RKN method on y'' = -w^2 y: the largest
+  // H = w dt up to which the step matrix of (y, dt y') keeps a complex eigenvalue
+  // pair or real eigenvalues of modulus <= 1. The weak amplitude growth of the
+  // complex pair of non-dissipative methods (RKN5) is their order error and
+  // accepted. About 2.59 for RKN4 and 3.12 for RKN5.
+  template <class Coefficients>
+  double stabilityInterval(Coefficients& coefficients, double dH = 1e-3, double maxH = 10.0)
+  {
+    const int s = coefficients.stages();
+    const CoeffMatrix A = coefficients.A();
+    const CoeffVector b = coefficients.b();
+    const CoeffVector b_bar = coefficients.b_bar();
+    const CoeffVector c = coefficients.c();
+    std::vector<double> K1(s), Kc(s);
+
+    for(double H=dH; H<maxH; H+=dH) {
+      // stages K = dt^2 k = y K1 + dt y' Kc, (I - zA) K1 = z 1, (I - zA) Kc = z c
+      const double z = -H*H;
+      for(int i=0; i<s; i++) {
+        K1[i] = z;
+        Kc[i] = z*c[i][0];
+        for(int j=0; j<i; j++) {
+          K1[i] += z*A[i][j][0][0]*K1[j];
+          Kc[i] += z*A[i][j][0][0]*Kc[j];
+        }
+      }
 
-    static CoeffVector b_bar(4);
-	b_bar[0] = 14.0/336.0; b_bar[1] = 100.0/336.0; b_bar[2] = 54.0/336.0; b_bar[3] = 0.0;
-			
-	static CoeffVector b(4);
-	b[0] = 14.0/336.0; b[1] = 125.0/336.0; b[2] = 162.0/336.0; b[3] = 35.0/336.0;
-			
-	static CoeffVector c(4);
-	c[0] = 0.0; c[1] = 1.0/5.0; c[2] = 2.0/3.0; c[3] = 1.0;
-			
-	return RKNCoefficients(4, 5, A, b, b_bar, c);
+      double r00 = 1.0, r01 = 1.0, r10 = 0.0, r11 = 1.0;
+      for(int i=0; i<s; i++) {
+        r00 += b_bar[i][0]*K1[i];
+        r01 += b_bar[i][0]*Kc[i];
+        r10 += b[i][0]*K1[i];
+        r11 += b[i][0]*Kc[i];
+      }
+
+      const double trace = r00 + r11;
+      const double discriminant = 0.25*trace*trace - (r00*r11 - r01*r10);
+      if(discriminant >= 0.0 and std::abs(0.5*trace) + std::sqrt(discriminant) > 1.0)
+        return H - dH;
+    }
+    return maxH;
   }
   
   
@@ -138,32 +186,15 @@ namespace Dune {
   // ------------------------------------------------
   EmbeddedRKNCoefficients BettisRKN45()
   {
-    static CoeffMatrix A(6,6);
-	A[0][0] = 0.0; 	      A[0][1] = 0.0; 	   A[0][2] = 0.0; 	   A[0][3] = 0.0;       A[0][4] = 0.0;      A[0][5] = 0.0;
-	A[1][0] = 1.0/128.0;  A[1][1] = 0.0; 	   A[1][2] = 0.0; 	   A[1][3] = 0.0;       A[1][4] = 0.0;      A[1][5] = 0.0;
-	A[2][0] = 1.0/96.0;   A[2][1] = 1.0/48.0;  A[2][2] = 0.0; 	   A[2][3] = 0.0;       A[2][4] = 0.0;      A[2][5] = 0.0;
-	A[3][0] = 1.0/24.0;   A[3][1] = 0.0;       A[3][2] = 1.0/12.0; A[3][3] = 0.0;       A[3][4] = 0.0;      A[3][5] = 0.0;
-	A[4][0] = 9.0/128.0;  A[4][1] = 0.0;       A[4][2] = 9.0/64.0; A[4][3] = 9.0/128.0; A[4][4] = 0.0;      A[4][5] = 0.0;
-    A[5][0] = 7.0/90.0;   A[5][1] = 0.0;       A[5][2] = 4.0/15.0; A[5][3] = 1.0/15.0;  A[5][4] = 4.0/45.0; A[5][5] = 0.0;
-
-    static CoeffVector b_bar_tilde(6);
-    b_bar_tilde[0] = 7.0/90.0; b_bar_tilde[1] = 0.0; b_bar_tilde[2] = 4.0/15.0;
-    b_bar_tilde[3] = 1.0/15.0; b_bar_tilde[4] = 4.0/45.0; b_bar_tilde[5] = 0.0;   
-            
-    static CoeffVector b_bar(6);
-    b_bar[0] = 1.0/6.0; b_bar[1] = 0.0; b_bar[2] = 0.0; b_bar[3] = 1.0/3.0; b_bar[4] = 0.0; b_bar[5] = 0.0;
-			
-    static CoeffVector b_tilde(6);
-    b_tilde[0] = 7.0/90.0; b_tilde[1] = 0.0; b_tilde[2] = 16.0/45.0;
-    b_tilde[3] = 2.0/15.0; b_tilde[4] = 16.0/45.0; b_tilde[5] = 7.0/90.0;
+    using T = BettisRKN45Tableau;
+    static CoeffMatrix A           = coeffMatrix<T::stages>(T::A);
+    static CoeffVector b_bar_tilde = coeffVector<T::stages>(T::b_bar_tilde);
+    static CoeffVector b_bar       = coeffVector<T::stages>(T::b_bar);
+    static CoeffVector b_tilde     = coeffVector<T::stages>(T::b_tilde);
+    static CoeffVector b           = coeffVector<T::stages>(T::b);
+    static CoeffVector c           = coeffVector<T::stages>(T::c);
 
-    static CoeffVector b(6);			
-    b[0] = 0.0; b[1] = 0.0; b[2] = 2.0/3.0; b[3] = -1.0/3.0; b[4] = 2.0/3.0; b[5] = 0.0;
-	
-	static CoeffVector c(6);
-	c[0] = 0.0; c[1] = 1.0/8.0; c[2] = 1.0/4.0; c[3] = 1.0/2.0; c[4] = 3.0/4.0, c[5] = 1.0;
-			
-    return EmbeddedRKNCoefficients(6, 4, A, b, b_bar, b_tilde, b_bar_tilde, c);
+    return EmbeddedRKNCoefficients(T::stages, T::order, A, b, b_bar, b_tilde, b_bar_tilde, c);
   }
   
   // Emmbeded Runge-Kutta-Nyström method of order 6 5
@@ -171,69 +202,31 @@ namespace Dune {
   // ------------------------------------------------
   EmbeddedRKNCoefficients DPRKN64()
   {
-    static CoeffMatrix A(6,6);
-    A[0][0] = 0.0; 	              A[0][1] = 0.0; 	           A[0][2] = 0.0; 	           A[0][3] = 0.0;              A[0][4] = 0.0;             A[0][5] = 0.0;
-	A[1][0] = 1.0/200.0;          A[1][1] = 0.0; 	           A[1][2] = 0.0; 	           A[1][3] = 0.0;              A[1][4] = 0.0;             A[1][5] = 0.0;
-	A[2][0] = -1.0/2200.0;        A[2][1] = 1.0/22.0;          A[2][2] = 0.0; 	           A[2][3] = 0.0;              A[2][4] = 0.0;             A[2][5] = 0.0;
-	A[3][0] = 637.0/6600.0;       A[3][1] = -7.0/110.0;        A[3][2] = 7.0/33.0;         A[3][3] = 0.0;              A[3][4] = 0.0;             A[3][5] = 0.0;
-	A[4][0] = 225437.0/1968750.0; A[4][1] = -30073.0/281250.0; A[4][2] = 65569.0/281250.0; A[4][3] = -9367.0/984375.0; A[4][4] = 0.0;             A[4][5] = 0.0;
-    A[5][0] = 151.0/2142.0;       A[5][1] = 5.0/116.0;         A[5][2] = 385.0/1368.0;     A[5][3] = 55.0/168.0;       A[5][4] = -6250.0/28101.0; A[5][5] = 0.0;
- 
-    static CoeffVector b_bar_tilde(6);
-    b_bar_tilde[0] = 151.0/2142.0; b_bar_tilde[1] = 5.0/116.0; b_bar_tilde[2] = 385.0/1368.0;
-    b_bar_tilde[3] = 55.0/168.0; b_bar_tilde[4] = -6250.0/28101.0; b_bar_tilde[5] = 0.0;
-    
-    static CoeffVector b_bar(6);
-    b_bar[0] = 1349.0/157500.0; b_bar[1] = 7873.0/50000.0; b_bar[2] = 192199.0/900000.0; b_bar[3] = 521683.0/2100000.0; b_bar[4] = -16.0/125.0; b_bar[5] = 0.0;
-    
-    static CoeffVector b_tilde(6);
-    b_tilde[0] = 151.0/2142.0; b_tilde[1] = 25.0/522.0; b_tilde[2] = 275.0/684.0;
-    b_tilde[3] = 275.0/252.0; b_tilde[4] = -78125.0/112404.0; b_tilde[5] = 1.0/12.0;
-    
-    static CoeffVector b(6);
-    b[0] = 1349.0/157500.0; b[1] = 7873.0/45000.0; b[2] = 27457.0/90000.0; b[3] = 521683.0/630000.0; b[4] = -2.0/5.0; b[5] = 1.0/12.0;
+    using T = DPRKN64Tableau;
+    static CoeffMatrix A           = coeffMatrix<T::stages>(T::A);
+    static CoeffVector b_bar_tilde = coeffVector<T::stages>(T::b_bar_tilde);
+    static CoeffVector b_bar       = coeffVector<T::stages>(T::b_bar);
+    static CoeffVector b_tilde     = coeffVector<T::stages>(T::b_tilde);
+    static CoeffVector b           = coeffVector<T::stages>(T::b);
+    static CoeffVector c           = coeffVector<T::stages>(T::c);
 
-    static CoeffVector c(6);
-    c[0] = 0.0; c[1] = 1.0/10.0; c[2] = 3.0/10.0; c[3] = 7.0/10.0; c[4] = 17.0/25.0; c[5] = 1.0;
-  
-    return EmbeddedRKNCoefficients(6, 4, A, b, b_bar, b_tilde, b_bar_tilde, c);
+    return EmbeddedRKNCoefficients(T::stages, T::order, A, b, b_bar, b_tilde, b_bar_tilde, c);
   }
   
+  // Emmbeded Runge-Kutta-Nyström method of order 8 6
+  // Domain-Prince coefficients
+  // ------------------------------------------------
   EmbeddedRKNCoefficients DPRKN86()
   {
-    static CoeffMatrix A(9,9);
-    A[0][0] = 0.0; 	                     A[0][1] = 0.0; 	               A[0][2] = 0.0; 	                   A[0][3] = 0.0;                    A[0][4] = 0.0;             A[0][5] = 0.0;            A[0][6] = 0.0;            A[0][7] = 0.0; A[0][8] = 0.0;
-	A[1][0] = 1.0/800.0;                 A[1][1] = 0.0; 	               A[1][2] = 0.0; 	                   A[1][3] = 0.0;                    A[1][4] = 0.0;             A[1][5] = 0.0;            A[1][6] = 0.0;            A[1][7] = 0.0; A[1][8] = 0.0;
-	A[2][0] = 1.0/600.0;                 A[2][1] = 1.0/300.0;              A[2][2] = 0.0; 	                   A[2][3] = 0.0;                    A[2][4] = 0.0;             A[2][5] = 0.0;            A[2][6] = 0.0;            A[2][7] = 0.0; A[2][8] = 0.0;
-	A[3][0] = 9.0/200.0;                 A[3][1] = -9.0/100.0;             A[3][2] = 9.0/100.0;                A[3][3] = 0.0;                    A[3][4] = 0.0;             A[3][5] = 0.0;            A[3][6] = 0.0;            A[3][7] = 0.0; A[3][8] = 0.0;
-	A[4][0] = -66701.0/197352.0;         A[4][1] = 28325.0/32892.0;        A[4][2] = -2665.0/5482.0;           A[4][3] = 2170.0/24669.0;         A[4][4] = 0.0;             A[4][5] = 0.0;            A[4][6] = 0.0;            A[4][7] = 0.0; A[4][8] = 0.0;
-    A[5][0] = 227015747.0/304251000.0;   A[5][1] = -54897451.0/30425100.0; A[5][2] = 12942349.0/10141700.0;    A[5][3] = -9499.0/304251.0;         A[5][4] = 539.0/9250.0;    A[5][5] = 0.0;            A[5][6] = 0.0;            A[5][7] = 0.0; A[5][8] = 0.0;
-    A[6][0] = -1131891597.0/901789000.0; A[6][1] = 41964921.0/12882700.0;  A[6][2] = -6663147.0/3320675.0;     A[6][3] = 270954.0/644135.0;      A[6][4] = -108.0/5875.0;   A[6][5] = 114.0/1645.0;   A[6][6] = 0.0;            A[6][7] = 0.0; A[6][8] = 0.0;
-    A[7][0] = 13836959.0/3667458.0;      A[7][1] = -17731450.0/1833729.0;  A[7][2] = 1063919505.0/156478208.0; A[7][3] = -33213845.0/39119552.0; A[7][4] = 13335.0/28544.0; A[7][5] = -705.0/14272.0; A[7][6] = 1645.0/57088.0; A[7][7] = 0.0; A[7][8] = 0.0;
-    A[8][0] = 223.0/7938.0;              A[8][1] = 0.0;                    A[8][2] = 1175.0/8064.0;            A[8][3] = 925.0/6048.0;           A[8][4] = 41.0/448.0;      A[8][5] = 925.0/14112.0;  A[8][6] = 1175.0/72576.0; A[8][7] = 0.0; A[8][8] = 0.0;
- 
- 
-    static CoeffVector b_bar_tilde(9);
-    b_bar_tilde[0] = 223.0/7938.0; b_bar_tilde[1] = 0.0; b_bar_tilde[2] = 1175.0/8064.0; b_bar_tilde[3] = 925.0/6048.0; b_bar_tilde[4] = 41.0/448.0;
-    b_bar_tilde[5] = 925.0/14112.0; b_bar_tilde[6] = 1175.0/72576.0; b_bar_tilde[7] = 0.0; b_bar_tilde[8] = 0.0;
-    
-    static CoeffVector b_bar(9);
-    b_bar[0] = 7987313.0/109941300.0; b_bar[1] = 0.0; b_bar[2] = 1610737.0/44674560.0; b_bar[3] = 10023263.0/33505920.0; 
-    b_bar[4] = -497221.0/12409600.0; b_bar[5] = 10023263.0/78180480.0; b_bar[6] = 1610737.0/402071040.0; b_bar[7] = 0.0; b_bar[8] = 0.0;
-    
-    static CoeffVector b_tilde(9);
-    b_tilde[0] = 223.0/7938.0; b_tilde[1] = 0.0; b_tilde[2] = 5875.0/36288.0; b_tilde[3] = 4625.0/21168.0; b_tilde[4] = 41.0/224.0; 
-    b_tilde[5] = 4625.0/21168.0; b_tilde[6] = 5875.0/36288.0; b_tilde[7] = 223.0/7938.0; b_tilde[8] = 0.0;
-    
-    static CoeffVector b(9);
-    b[0] = 7987313.0/109941300.0; b[1] = 0.0; b[2] = 1610737.0/40207104.0; b[3] = 10023263.0/23454144.0; b[4] = -497221.0/6204800.0; 
-    b[5] = 10023263.0/23454144.0; b[6] = 1610737.0/402071040.0; b[7] = -4251941.0/54970650.0; b[8] = 3.0/20.0;
+    using T = DPRKN86Tableau;
+    static CoeffMatrix A           = coeffMatrix<T::stages>(T::A);
+    static CoeffVector b_bar_tilde = coeffVector<T::stages>(T::b_bar_tilde);
+    static CoeffVector b_bar       = coeffVector<T::stages>(T::b_bar);
+    static CoeffVector b_tilde     = coeffVector<T::stages>(T::b_tilde);
+    static CoeffVector b           = coeffVector<T::stages>(T::b);
+    static CoeffVector c           = coeffVector<T::stages>(T::c);
 
-    static CoeffVector c(9);
-    c[0] = 0.0; c[1] = 1.0/20.0; c[2] = 1.0/10.0; c[3] = 3.0/10.0; c[4] = 1.0/2.0; c[5] = 7.0/10.0; c[6] = 9.0/10.0; c[7] = 1.0; c[8] = 1.0;
-  
-    return EmbeddedRKNCoefficients(9, 6, A, b, b_bar, b_tilde, b_bar_tilde, c);
-  
+    return EmbeddedRKNCoefficients(T::stages, T::order, A, b, b_bar, b_tilde, b_bar_tilde, c);
   }
   
     
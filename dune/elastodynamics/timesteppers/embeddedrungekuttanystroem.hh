@@ -4,13 +4,136 @@
 #ifndef EMBEDDED_RUNGE_KUTTA_NYSTROEM_HH
 #define EMBEDDED_RUNGE_KUTTA_NYSTROEM_HH
 
+#include <algorithm>
+#include <array>
+#include <string>
+
 #include "coefficients.hh"
+#include "tableaux.hh"
 #include "timestepcontroller.hh"
 
 namespace Dune {
-  
-  template <typename MatrixType, typename VectorType>	
+
+  // embedded Runge-Kutta-Nyström method with a compile-time tableau
+  // the stage loops are unrolled and zero coefficients are skipped
+  template <typename MatrixType, typename VectorType, typename Tableau = DynamicTableau>
   class EmbeddedRungeKuttaNystroem {
+
+    private:
+
+      AdaptiveStepController *adaptive_;
+      double dt_;
+
+      MatrixType lumpedmass_, stiffness_;
+
+      std::array<VectorType, Tableau::stages> k;
+      VectorType loadupdate_;
+
+    public:
+
+      EmbeddedRungeKuttaNystroem(MatrixType& lumpedmass,
+                                 MatrixType& stiffness,
+                                 AdaptiveStepController* adaptive)
+      : adaptive_(adaptive)
+      , lumpedmass_(lumpedmass)
+      , stiffness_(stiffness)
+      {}
+
+      void initialize(VectorType& load)
+      {
+        // initialize stages
+        for(auto& stage : k) {
+          stage.resize(load.size());
+          stage = 0.0;
+        }
+        loadupdate_.resize(load.size());
+      }
+
+      // the stages are recomputed in every step, the adaptive controller is state
+      template <class Writer>
+      void save(Writer& writer, const std::string& prefix = "embeddedrkn") const
+      {
+        adaptive_->save(writer, prefix + ".controller");
+      }
+
+      template <class Reader>
+      void restore(Reader& reader, const std::string& prefix = "embeddedrkn")
+      {
+        adaptive_->restore(reader, prefix + ".controller");
+      }
+
+      void step(VectorType& displacement,
+                VectorType& velocity,
+                VectorType& acceleration,
+                VectorType& load)
+      {
+
+        while(1)
+        {
+          // store values of last timestep
+          VectorType displacement_ = displacement;
+          VectorType displacement_tilde_ = displacement;
+          VectorType velocity_ = velocity;
+          VectorType velocity_tilde_ = velocity;
+
+          // get current timestep size
+          dt_ = adaptive_->deltaT();
+
+          // calculate function evaluation vectors k
+          unroll<Tableau::stages>([&](auto i) {
+            constexpr int I = decltype(i)::value;
+            k[I] = displacement;
+            if constexpr (Tableau::c[I] != 0.0)
+              k[I].axpy(dt_*Tableau::c[I], velocity);
+            unroll<I>([&](auto j) {
+              constexpr int J = decltype(j)::value;
+              if constexpr (Tableau::A[I][J] != 0.0)
+                k[I].axpy(dt_*dt_*Tableau::A[I][J], k[J]);
+            });
+
+            // function evaluation
+            loadupdate_ = load;
+            stiffness_.mmv(k[I], loadupdate_);
+            lumpedmass_.mv(loadupdate_, k[I]);
+          });
+
+          // perform update
+          displacement_.axpy(dt_, velocity_);
+          displacement_tilde_.axpy(dt_, velocity_tilde_);
+          unroll<Tableau::stages>([&](auto i) {
+            constexpr int I = decltype(i)::value;
+            if constexpr (Tableau::b_bar[I] != 0.0)
+              displacement_.axpy(dt_*dt_*Tableau::b_bar[I], k[I]);
+            if constexpr (Tableau::b_bar_tilde[I] != 0.0)
+              displacement_tilde_.axpy(dt_*dt_*Tableau::b_bar_tilde[I], k[I]);
+            if constexpr (Tableau::b[I] != 0.0)
+              velocity_.axpy(dt_*Tableau::b[I], k[I]);
+            if constexpr (Tableau::b_tilde[I] != 0.0)
+              velocity_tilde_.axpy(dt_*Tableau::b_tilde[I], k[I]);
+          });
+
+          // calculate error
+          displacement_ -= displacement_tilde_;
+          velocity_ -= velocity_tilde_;
+          double error_ = std::max(displacement_.infinity_norm(), velocity_.infinity_norm());
+
+          // get new timestep
+          bool accepted = adaptive_->timeStepValid(dt_, error_, Tableau::order);
+
+          if(accepted)
+          {
+            displacement = displacement_tilde_;
+            velocity = velocity_tilde_;
+            adaptive_->advance(dt_);
+            break;
+          }
+        }
+      }
+  };
+
+  // embedded Runge-Kutta-Nyström method with coefficients given at runtime
+  template <typename MatrixType, typename VectorType>	
+  class EmbeddedRungeKuttaNystroem<MatrixType, VectorType, DynamicTableau> {
   
     private:
 	  
@@ -55,6 +178,19 @@ namespace Dune {
 	    }
       }
 	
+      // the stages are recomputed in every step, the adaptive controller is state
+      template <class Writer>
+      void save(Writer& writer, const std::string& prefix = "embeddedrkn") const
+      {
+        adaptive_->save(writer, prefix + ".controller");
+      }
+
+      template <class Reader>
+      void restore(Reader& reader, const std::string& prefix = "embeddedrkn")
+      {
+        adaptive_->restore(reader, prefix + ".controller");
+      }
+
 	  void step(VectorType& displacement,
                 VectorType& velocity,
                 VectorType& acceleration,
@@ -111,6 +247,7 @@ namespace Dune {
 	      {
 	        displacement = displacement_tilde_;
 	        velocity = velocity_tilde_;
+	        adaptive_->advance(dt_);
 	        break;
 	      }	 
 	    }	    
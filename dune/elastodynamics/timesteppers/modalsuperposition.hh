@@ -0,0 +1,151 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef MODAL_SUPERPOSITION_HH
+#define MODAL_SUPERPOSITION_HH
+
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "timestepcontroller.hh"
+
+#include <dune/elastodynamics/eigensolvers/subspaceiteration.hh>
+
+namespace Dune {
+
+  // Modal superposition for linear problems
+  // the lowest eigenpairs of K x = w^2 M x are computed once, afterwards the
+  // modal coordinates are advanced exactly for arbitrary dt (no solves, no
+  // stability limit), the load is held constant during a step
+  template <typename MatrixType, typename VectorType>
+  class ModalSuperposition {
+
+    private:
+
+      TimeStepController fixed_;
+      double dt_;
+
+      MatrixType mass_;
+
+      std::vector<double> omega_;
+      std::vector<VectorType> modes_;
+      std::vector<double> q_, qd_, cos_, sin_;
+      double cachedDt_ = -1.0;
+
+      void project(const VectorType& vector, std::vector<double>& coordinates)
+      {
+        VectorType Mv(vector.size());
+        mass_.mv(vector, Mv);
+        for(std::size_t i=0; i<modes_.size(); i++)
+          coordinates[i] = modes_[i].dot(Mv);
+      }
+
+    public:
+
+      // constrained as for the SubspaceIteration, e.g. BoundaryDofs::dofs(1)
+      ModalSuperposition(MatrixType& mass,
+                         MatrixType& stiffness,
+                         const std::vector<std::size_t>& constrained,
+                         int modes,
+                         TimeStepController& fixed,
+                         double tol = 1e-8,
+                         const std::vector<std::pair<std::size_t, int>>& constrainedComponents = {})
+      : fixed_(fixed)
+      , mass_(mass)
+      {
+        std::vector<double> eigenvalues;
+        Elastodynamics::SubspaceIteration<MatrixType, VectorType> eigensolver(mass_, stiffness, constrained, 100, tol,
+                                                                              0, constrainedComponents);
+        eigensolver.apply(modes, eigenvalues, modes_);
+
+        omega_.resize(modes);
+        for(int i=0; i<modes; i++)
+          omega_[i] = std::sqrt(std::max(eigenvalues[i], 0.0));
+
+        q_.assign(modes, 0.0);
+        qd_.assign(modes, 0.0);
+        cos_.assign(modes, 1.0);
+        sin_.assign(modes, 0.0);
+      }
+
+      const std::vector<double>& frequencies() const { return omega_; }
+
+      const std::vector<VectorType>& modes() const { return modes_; }
+
+      // same interface as the other steppers, the modal coordinates start at
+      // rest (or at setInitialValues) and do not depend on the load
+      void initialize(VectorType& load)
+      {}
+
+      // modal initial conditions q = Phi^T M u, q' = Phi^T M v
+      void setInitialValues(const VectorType& displacement, const VectorType& velocity)
+      {
+        project(displacement, q_);
+        project(velocity, qd_);
+      }
+
+      // the modal coordinates are state, the eigenbasis is recomputed
+      // deterministically by the constructor
+      template <class Writer>
+      void save(Writer& writer, const std::string& prefix = "modal") const
+      {
+        fixed_.save(writer, prefix + ".controller");
+        writer.write(prefix + ".q", q_);
+        writer.write(prefix + ".qd", qd_);
+      }
+
+      template <class Reader>
+      void restore(Reader& reader, const std::string& prefix = "modal")
+      {
+        fixed_.restore(reader, prefix + ".controller");
+        reader.read(prefix + ".q", q_);
+        reader.read(prefix + ".qd", qd_);
+      }
+
+      void step(VectorType& displacement,
+                VectorType& velocity,
+                VectorType& acceleration,
+                VectorType& load)
+      {
+        // get fixed timestep size
+        dt_ = fixed_.deltaT();
+
+        if(dt_ != cachedDt_) {
+          for(std::size_t i=0; i<omega_.size(); i++) {
+            cos_[i] = std::cos(omega_[i]*dt_);
+            sin_[i] = std::sin(omega_[i]*dt_);
+          }
+          cachedDt_ = dt_;
+        }
+
+        displacement = 0.0;
+        velocity = 0.0;
+        acceleration = 0.0;
+
+        for(std::size_t i=0; i<modes_.size(); i++) {
+          const double f = modes_[i].dot(load);
+          const double w = omega_[i];
+
+          // exact solution of q'' + w^2 q = f
+          if(w > 0.0) {
+            const double qs = f/(w*w);
+            const double q = qs + (q_[i]-qs)*cos_[i] + qd_[i]/w*sin_[i];
+            qd_[i] = -(q_[i]-qs)*w*sin_[i] + qd_[i]*cos_[i];
+            q_[i] = q;
+          } else {
+            q_[i] += dt_*qd_[i] + 0.5*dt_*dt_*f;
+            qd_[i] += dt_*f;
+          }
+
+          displacement.axpy(q_[i], modes_[i]);
+          velocity.axpy(qd_[i], modes_[i]);
+          acceleration.axpy(f-w*w*q_[i], modes_[i]);
+        }
+        fixed_.advance(dt_);
+      }
+  };
+}
+
+#endif
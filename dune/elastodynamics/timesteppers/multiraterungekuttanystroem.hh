@@ -0,0 +1,261 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef MULTIRATE_RUNGE_KUTTA_NYSTROEM_HH
+#define MULTIRATE_RUNGE_KUTTA_NYSTROEM_HH
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "coefficients.hh"
+#include "timestepcontroller.hh"
+
+namespace Dune {
+
+  // Multirate Runge-Kutta-Nyström method (subcycling)
+  // -------------------------------------------------
+  // The dofs are sorted into levels by a nodal (Gershgorin) estimate of their
+  // stable timestep, safety times the stability interval of the method over the
+  // highest nodal frequency. Level l is advanced with dt/2^l, so only the small
+  // elements pay for the small timestep. The levels belong to one dt, a step
+  // with a different dt (e.g. after a restore) sorts the dofs again. During a
+  // stage of level l the coarser neighbours are interpolated linearly in time,
+  // the finer ones are predicted with their current velocity.
+  template <typename MatrixType, typename VectorType>
+  class MultirateRungeKuttaNystroem {
+
+    private:
+
+      using MassBlock = typename MatrixType::block_type;
+
+      TimeStepController fixed_;
+      double dt_;
+
+      MatrixType stiffness_;
+      std::vector<MassBlock> lumpedmass_;
+
+      int stages_, order_, levels_, maxLevels_;
+      double safety_, interval_, partitionDt_;
+      Dune::Matrix<Dune::FieldMatrix<double, 1, 1>> A_;
+      Dune::BlockVector<Dune::FieldVector<double, 1>> b_, b_bar_, c_;
+      Dune::BlockVector<VectorType> k;
+
+      std::vector<int> level_;
+      std::vector<std::vector<std::size_t>> dofs_, halo_;
+      std::vector<double> levelStart_;
+      VectorType previous_, stage_;
+
+      void partition()
+      {
+        partitionDt_ = dt_;
+        const std::size_t n = stiffness_.N();
+        level_.assign(n, 0);
+
+        // nodal estimate of the highest frequency w^2 <= |K_r|_1/m_r
+        for(std::size_t r=0; r<n; r++) {
+          double omega2 = 0.0;
+          for(std::size_t p=0; p<lumpedmass_[r].N(); p++) {
+            double rowSum = 0.0;
+            for(auto col = stiffness_[r].begin(); col != stiffness_[r].end(); ++col) {
+              for(std::size_t q=0; q<(*col).M(); q++) {
+                rowSum += std::abs((*col)[p][q]);
+              }
+            }
+            omega2 = std::max(omega2, rowSum*std::abs(lumpedmass_[r][p][p]));
+          }
+          if(omega2 > 0.0) {
+            double dtLocal = safety_*interval_/std::sqrt(omega2);
+            int l = static_cast<int>(std::ceil(std::log2(dt_/dtLocal)));
+            level_[r] = std::clamp(l, 0, maxLevels_-1);
+          }
+        }
+
+        // coupled dofs must not be more than one level apart
+        bool changed = true;
+        while(changed) {
+          changed = false;
+          for(std::size_t r=0; r<n; r++) {
+            for(auto col = stiffness_[r].begin(); col != stiffness_[r].end(); ++col) {
+              if(level_[col.index()] > level_[r]+1) {
+                level_[r] = level_[col.index()]-1;
+                changed = true;
+              }
+            }
+          }
+        }
+
+        levels_ = 1 + *std::max_element(level_.begin(), level_.end());
+        dofs_.assign(levels_, {});
+        halo_.assign(levels_, {});
+        levelStart_.assign(levels_, 0.0);
+
+        for(std::size_t r=0; r<n; r++) {
+          dofs_[level_[r]].push_back(r);
+          for(auto col = stiffness_[r].begin(); col != stiffness_[r].end(); ++col) {
+            if(level_[col.index()] != level_[r])
+              halo_[level_[r]].push_back(col.index());
+          }
+        }
+
+        for(auto& halo : halo_) {
+          std::sort(halo.begin(), halo.end());
+          halo.erase(std::unique(halo.begin(), halo.end()), halo.end());
+        }
+      }
+
+      // M^-1(f-Ku) restricted to the rows of one level
+      void evaluate(int l, const VectorType& load, VectorType& result)
+      {
+        for(auto r : dofs_[l]) {
+          auto residual = load[r];
+          for(auto col = stiffness_[r].begin(); col != stiffness_[r].end(); ++col) {
+            (*col).mmv(stage_[col.index()], residual);
+          }
+          lumpedmass_[r].mv(residual, result[r]);
+        }
+      }
+
+      void levelStep(int l, double start,
+                     VectorType& displacement,
+                     VectorType& velocity,
+                     const VectorType& load)
+      {
+        const double h = dt_/(1 << l);
+
+        for(int i=0; i<stages_; i++)
+        {
+          // stage argument on the dofs of this level
+          for(auto r : dofs_[l]) {
+            stage_[r] = displacement[r];
+            stage_[r].axpy(h*c_[i], velocity[r]);
+            for(int j=0; j<i; j++) {
+              stage_[r].axpy(h*h*A_[i][j], k[j][r]);
+            }
+          }
+
+          // coupled dofs of other levels at the stage time
+          const double t = start + c_[i]*h;
+          for(auto r : halo_[l]) {
+            const int m = level_[r];
+            if(m < l) {
+              double theta = (t - levelStart_[m])*(1 << m)/dt_;
+              stage_[r] = previous_[r];
+              stage_[r] *= 1.0-theta;
+              stage_[r].axpy(theta, displacement[r]);
+            } else {
+              stage_[r] = displacement[r];
+              stage_[r].axpy(t-start, velocity[r]);
+            }
+          }
+
+          // function evaluation
+          evaluate(l, load, k[i]);
+        }
+
+        // keep the old state for the interpolation of finer levels
+        for(auto r : dofs_[l]) {
+          previous_[r] = displacement[r];
+        }
+        levelStart_[l] = start;
+
+        // perform update
+        for(auto r : dofs_[l]) {
+          displacement[r].axpy(h, velocity[r]);
+          for(int i=0; i<stages_; i++) {
+            displacement[r].axpy(h*h*b_bar_[i], k[i][r]);
+            velocity[r].axpy(h*b_[i], k[i][r]);
+          }
+        }
+      }
+
+    public:
+
+      // lumpedmass is expected to be inverted already, like for RungeKuttaNystroem
+      MultirateRungeKuttaNystroem(MatrixType& lumpedmass,
+                                  MatrixType& stiffness,
+                                  RKNCoefficients& coefficients,
+                                  TimeStepController& fixed,
+                                  int maxLevels,
+                                  double safety = 0.5)
+      : fixed_(fixed)
+      , dt_(fixed.deltaT())
+      , stiffness_(stiffness)
+      , stages_(coefficients.stages())
+      , order_(coefficients.order())
+      , maxLevels_(maxLevels)
+      , safety_(safety)
+      , interval_(stabilityInterval(coefficients))
+      , A_(coefficients.A())
+      , b_(coefficients.b())
+      , b_bar_(coefficients.b_bar())
+      , c_(coefficients.c())
+      {
+        lumpedmass_.resize(lumpedmass.N());
+        for(std::size_t r=0; r<lumpedmass.N(); r++) {
+          lumpedmass_[r] = lumpedmass[r][r];
+        }
+
+        // sort dofs into levels
+        partition();
+
+        // set storage for stages
+        k.resize(stages_);
+      }
+
+      void initialize(VectorType& load)
+      {
+        // initialize stages
+        for(int i=0; i<stages_; i++) {
+          k[i].resize(load.size());
+          k[i] = 0.0;
+        }
+        stage_.resize(load.size());
+        stage_ = 0.0;
+        previous_.resize(load.size());
+        previous_ = 0.0;
+      }
+
+      int levels() const { return levels_; }
+
+      const std::vector<int>& dofLevels() const { return level_; }
+
+      // all levels are synchronous after a step, only the controller is state
+      template <class Writer>
+      void save(Writer& writer, const std::string& prefix = "multiraterkn") const
+      {
+        fixed_.save(writer, prefix + ".controller");
+      }
+
+      template <class Reader>
+      void restore(Reader& reader, const std::string& prefix = "multiraterkn")
+      {
+        fixed_.restore(reader, prefix + ".controller");
+      }
+
+      void step(VectorType& displacement,
+                VectorType& velocity,
+                VectorType& acceleration,
+                VectorType& load)
+      {
+        // get fixed (coarsest) timestep size, the levels are only stable for
+        // the dt they were sorted for
+        dt_ = fixed_.deltaT();
+        if(dt_ != partitionDt_)
+          partition();
+
+        // walk through the finest substeps, coarse levels first
+        const int substeps = 1 << (levels_-1);
+        for(int s=0; s<substeps; s++) {
+          for(int l=0; l<levels_; l++) {
+            if(s % (substeps >> l) == 0)
+              levelStep(l, s*dt_/substeps, displacement, velocity, load);
+          }
+        }
+        fixed_.advance(dt_);
+      }
+  };
+}
+
+#endif
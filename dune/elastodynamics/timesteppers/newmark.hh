@@ -4,7 +4,12 @@
 #ifndef NEWMARK_HH
 #define NEWMARK_HH
 
+#include <functional>
+#include <memory>
+#include <string>
+
 #include "coefficients.hh"
+#include "prescribedmotion.hh"
 #include "timestepcontroller.hh"
 
 #include <dune/istl/umfpack.hh>
@@ -22,6 +27,25 @@ namespace Dune {
 	  MatrixType efficient_mass_, mass_, stiffness_;	
 	  double beta_, gamma_;
 
+      using Solver = InverseOperator<VectorType, VectorType>;
+      std::function<std::shared_ptr<Solver>(const MatrixType&)> solverFactory_;
+      std::shared_ptr<Solver> solver_;
+
+      const PrescribedMotion<VectorType>* motion_ = nullptr;
+
+      // efficient mass M + beta dt^2 K and its solver, UMFPack factorizes it once
+      void setupSolver()
+      {
+        dt_ = fixed_.deltaT();
+        efficient_mass_ = mass_;
+        efficient_mass_.axpy(beta_*dt_*dt_, stiffness_);
+
+        if(solverFactory_)
+          solver_ = solverFactory_(efficient_mass_);
+        else
+          solver_ = std::make_shared<UMFPack<MatrixType>>(efficient_mass_, 1);
+      }
+
     public:
 	  
       Newmark(MatrixType& mass,
@@ -35,6 +59,23 @@ namespace Dune {
       , fixed_(fixed)
 	  {}
 
+
+      // iterative solver for the efficient mass instead of UMFPack, e.g. CG with
+      // GeometricMultigrid, the previous acceleration is the initial guess;
+      // has to be set before initialize()
+      void setSolver(std::function<std::shared_ptr<Solver>(const MatrixType&)> factory)
+      {
+        solverFactory_ = factory;
+      }
+
+
+      // constrained dofs follow the motion, their rows of the efficient mass have
+      // to be diagonal (row-wise Dirichlet elimination)
+      void setPrescribedMotion(const PrescribedMotion<VectorType>& motion)
+      {
+        motion_ = &motion;
+      }
+
                 
       void initialize(VectorType& acceleration,
 	                  VectorType load) // we only want a copy and not work on the memory here!
@@ -47,11 +88,23 @@ namespace Dune {
         solver.apply(acceleration, load, statistics);
         
         // calculate efficient mass matrix
-        dt_ = fixed_.deltaT();
-        efficient_mass_ = mass_;
-        efficient_mass_.axpy(beta_*dt_*dt_, stiffness_);
+        setupSolver();
       }
 
+
+      // the efficient mass is rebuilt from the restored timestep
+      template <class Writer>
+      void save(Writer& writer, const std::string& prefix = "newmark") const
+      {
+        fixed_.save(writer, prefix + ".controller");
+      }
+
+      template <class Reader>
+      void restore(Reader& reader, const std::string& prefix = "newmark")
+      {
+        fixed_.restore(reader, prefix + ".controller");
+        setupSolver();
+      }
 	
       void step(VectorType& displacement,
                 VectorType& velocity,
@@ -60,24 +113,37 @@ namespace Dune {
       {
         // get fixed timestepsize
         dt_ = fixed_.deltaT();
+        const double t = fixed_.time() + dt_;
     
         // predictor      
         displacement.axpy(dt_, velocity);
         displacement.axpy((0.5-beta_)*dt_*dt_, acceleration);
         velocity.axpy((1.0-gamma_)*dt_, acceleration);
+
+        // the predictor of the constrained dofs is chosen such that the corrector
+        // reproduces g(t), g'(t) exactly
+        if(motion_) {
+          motion_->assign(displacement, t, 1.0, 0.0, -beta_*dt_*dt_);
+          motion_->assign(velocity, t, 0.0, 1.0, -gamma_*dt_);
+        }
       
         // solve
         stiffness_.mmv(displacement, load);
+
+        // right hand side of the diagonal constrained rows yields a_d = g''(t)
+        if(motion_) {
+          motion_->assign(acceleration, t, 0.0, 0.0, 1.0);
+          for(auto d : motion_->dofs())
+            efficient_mass_[d][d].mv(acceleration[d], load[d]);
+        }
         
-        UMFPack<MatrixType> solver(efficient_mass_);
-        solver.setVerbosity(1);
- 
         InverseOperatorResult statistics;
-        solver.apply(acceleration, load, statistics);
+        solver_->apply(acceleration, load, statistics);
               
         // corrector
         velocity.axpy(gamma_*dt_, acceleration);
         displacement.axpy(beta_*dt_*dt_, acceleration);
+        fixed_.advance(dt_);
       }
   };
 }
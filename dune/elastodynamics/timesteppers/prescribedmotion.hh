@@ -0,0 +1,77 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef PRESCRIBED_MOTION_HH
+#define PRESCRIBED_MOTION_HH
+
+#include <functional>
+#include <vector>
+
+namespace Dune {
+
+  // Time-dependent displacements of constrained dofs (support motion, shakers),
+  // applied by the steppers at every stage without touching the matrices. The dofs
+  // are grouped, all dofs of a group follow the same displacement/velocity/
+  // acceleration callbacks, so a stage costs one call per group and one write per
+  // dof. The matrices need the row-wise Dirichlet elimination (assembleMatrix), the
+  // kept columns K_fd carry the motion into the free dofs.
+  template <typename VectorType>
+  class PrescribedMotion {
+
+    public:
+
+      using Block = typename VectorType::block_type;
+      using Function = std::function<Block(double)>;
+
+    private:
+
+      struct Group {
+        std::vector<std::size_t> dofs;
+        Function displacement, velocity, acceleration;
+      };
+
+      std::vector<Group> groups_;
+      std::vector<std::size_t> dofs_;
+
+    public:
+
+      // e.g. the dofs of a boundary id from BoundaryDofs
+      void add(const std::vector<std::size_t>& dofs,
+               Function displacement,
+               Function velocity,
+               Function acceleration)
+      {
+        groups_.push_back({dofs, displacement, velocity, acceleration});
+        dofs_.insert(dofs_.end(), dofs.begin(), dofs.end());
+      }
+
+      bool empty() const
+      {
+        return groups_.empty();
+      }
+
+      // all constrained dofs
+      const std::vector<std::size_t>& dofs() const
+      {
+        return dofs_;
+      }
+
+      // x_d = a g(t) + b g'(t) + c g''(t) on the constrained dofs
+      void assign(VectorType& x, double t, double a, double b, double c) const
+      {
+        for(const auto& group : groups_) {
+          Block value(0.0);
+          if(a != 0.0)
+            value.axpy(a, group.displacement(t));
+          if(b != 0.0)
+            value.axpy(b, group.velocity(t));
+          if(c != 0.0)
+            value.axpy(c, group.acceleration(t));
+          for(auto d : group.dofs)
+            x[d] = value;
+        }
+      }
+  };
+}
+
+#endif
@@ -4,29 +4,148 @@
 #ifndef RUNGE_KUTTA_NYSTROEM_HH
 #define RUNGE_KUTTA_NYSTROEM_HH
 
+#include <array>
+#include <string>
+
 #include "coefficients.hh"
+#include "prescribedmotion.hh"
+#include "tableaux.hh"
 #include "timestepcontroller.hh"
 
 namespace Dune {
-  
-  template <typename MatrixType, typename VectorType>	
+
+  // Runge-Kutta-Nyström method with a compile-time tableau
+  // the stage loops are unrolled and zero coefficients are skipped,
+  // the (inverted) lumped mass may have its own type, e.g. a BDMatrix next to
+  // a matrix-free SpectralElementOperator
+  template <typename MatrixType, typename VectorType, typename Tableau = DynamicTableau,
+            typename MassType = MatrixType>
   class RungeKuttaNystroem {
+
+    private:
+
+      TimeStepController fixed_;
+      double dt_;
+
+      MassType lumpedmass_;
+      MatrixType stiffness_;
+
+      std::array<VectorType, Tableau::stages> k;
+      VectorType loadupdate_;
+
+      const PrescribedMotion<VectorType>* motion_ = nullptr;
+
+    public:
+
+      RungeKuttaNystroem(MassType& lumpedmass,
+                         MatrixType& stiffness,
+                         TimeStepController& fixed)
+      : fixed_(fixed)
+      , lumpedmass_(lumpedmass)
+      , stiffness_(stiffness)
+      {}
+
+      void initialize(VectorType& load)
+      {
+        // initialize stages
+        for(auto& stage : k) {
+          stage.resize(load.size());
+          stage = 0.0;
+        }
+        loadupdate_.resize(load.size());
+      }
+
+      // constrained dofs follow the motion at every stage time t + c_i dt
+      void setPrescribedMotion(const PrescribedMotion<VectorType>& motion)
+      {
+        motion_ = &motion;
+      }
+
+      // the stages are recomputed in every step, only the controller is state
+      template <class Writer>
+      void save(Writer& writer, const std::string& prefix = "rkn") const
+      {
+        fixed_.save(writer, prefix + ".controller");
+      }
+
+      template <class Reader>
+      void restore(Reader& reader, const std::string& prefix = "rkn")
+      {
+        fixed_.restore(reader, prefix + ".controller");
+      }
+
+      void step(VectorType& displacement,
+                VectorType& velocity,
+                VectorType& acceleration,
+                VectorType& load)
+      {
+        // get fixed timestep size
+        dt_ = fixed_.deltaT();
+        const double t = fixed_.time();
+
+        // calculate function evaluation vectors k
+        unroll<Tableau::stages>([&](auto i) {
+          constexpr int I = decltype(i)::value;
+          k[I] = displacement;
+          if constexpr (Tableau::c[I] != 0.0)
+            k[I].axpy(dt_*Tableau::c[I], velocity);
+          unroll<I>([&](auto j) {
+            constexpr int J = decltype(j)::value;
+            if constexpr (Tableau::A[I][J] != 0.0)
+              k[I].axpy(dt_*dt_*Tableau::A[I][J], k[J]);
+          });
+          if(motion_)
+            motion_->assign(k[I], t + Tableau::c[I]*dt_, 1.0, 0.0, 0.0);
+
+          // function evaluation
+          loadupdate_ = load;
+          stiffness_.mmv(k[I], loadupdate_);
+          lumpedmass_.mv(loadupdate_, k[I]);
+          if(motion_)
+            motion_->assign(k[I], t + Tableau::c[I]*dt_, 0.0, 0.0, 1.0);
+        });
+
+        // perform update
+        displacement.axpy(dt_, velocity);
+        unroll<Tableau::stages>([&](auto i) {
+          constexpr int I = decltype(i)::value;
+          if constexpr (Tableau::b_bar[I] != 0.0)
+            displacement.axpy(dt_*dt_*Tableau::b_bar[I], k[I]);
+          if constexpr (Tableau::b[I] != 0.0)
+            velocity.axpy(dt_*Tableau::b[I], k[I]);
+        });
+
+        // exact values of the constrained dofs at t + dt
+        if(motion_) {
+          motion_->assign(displacement, t+dt_, 1.0, 0.0, 0.0);
+          motion_->assign(velocity, t+dt_, 0.0, 1.0, 0.0);
+        }
+        fixed_.advance(dt_);
+      }
+  };
+
+  // Runge-Kutta-Nyström method with coefficients given at runtime
+  template <typename MatrixType, typename VectorType, typename MassType>
+  class RungeKuttaNystroem<MatrixType, VectorType, DynamicTableau, MassType> {
   
     private:
 	  
       TimeStepController fixed_;
       double dt_;
 	
-	  MatrixType lumpedmass_, stiffness_;
+	  MassType lumpedmass_;
+	  MatrixType stiffness_;
 	
 	  int stages_, order_;
 	  Dune::Matrix<Dune::FieldMatrix<double, 1, 1>> A_;
 	  Dune::BlockVector<Dune::FieldVector<double, 1>> b_, b_bar_, c_;
 	  Dune::BlockVector<VectorType> k;
+
+      const PrescribedMotion<VectorType>* motion_ = nullptr;
 		
     public:
 	
-	  RungeKuttaNystroem(MatrixType& lumpedmass,
+	  RungeKuttaNystroem(MassType& lumpedmass,
 	   	                 MatrixType& stiffness,
 					     RKNCoefficients& coefficients,
 					     TimeStepController& fixed)
@@ -53,6 +172,25 @@ namespace Dune {
 	    }
       }
 	
+      // constrained dofs follow the motion at every stage time t + c_i dt
+      void setPrescribedMotion(const PrescribedMotion<VectorType>& motion)
+      {
+        motion_ = &motion;
+      }
+
+      // the stages are recomputed in every step, only the controller is state
+      template <class Writer>
+      void save(Writer& writer, const std::string& prefix = "rkn") const
+      {
+        fixed_.save(writer, prefix + ".controller");
+      }
+
+      template <class Reader>
+      void restore(Reader& reader, const std::string& prefix = "rkn")
+      {
+        fixed_.restore(reader, prefix + ".controller");
+      }
+
 	  void step(VectorType& displacement,
                 VectorType& velocity,
                 VectorType& acceleration,
@@ -60,6 +198,7 @@ namespace Dune {
       {
         // get fixed timestep size
 	    dt_ = fixed_.deltaT();
+        const double t = fixed_.time();
 		
 	    // calculate function evaluation vectors k
 	    for(int i=0; i<stages_; i++) 
@@ -69,12 +208,16 @@ namespace Dune {
 		  for (int j=0; j<i ; j++) {
 		    k[i].axpy(dt_*dt_*A_[i][j], k[j]);
 		  }
+          if(motion_)
+            motion_->assign(k[i], t + c_[i][0]*dt_, 1.0, 0.0, 0.0);
 	
 	      // function evaluation			
 		  VectorType loadupdate;
 	      loadupdate = load;
 		  stiffness_.mmv(k[i], loadupdate);
 		  lumpedmass_.mv(loadupdate, k[i]);
+          if(motion_)
+            motion_->assign(k[i], t + c_[i][0]*dt_, 0.0, 0.0, 1.0);
 	    }
 	    
 	    // perform update
@@ -83,7 +226,14 @@ namespace Dune {
 	    {
 	      displacement.axpy(dt_*dt_*b_bar_[i], k[i]);
 		  velocity.axpy(dt_*b_[i], k[i]);
-	    }	 	    
+	    }
+
+        // exact values of the constrained dofs at t + dt
+        if(motion_) {
+          motion_->assign(displacement, t+dt_, 1.0, 0.0, 0.0);
+          motion_->assign(velocity, t+dt_, 0.0, 1.0, 0.0);
+        }
+        fixed_.advance(dt_);
 	  }	
   };
 }
@@ -0,0 +1,161 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef TABLEAUX_HH
+#define TABLEAUX_HH
+
+#include <array>
+#include <type_traits>
+#include <utility>
+
+namespace Dune {
+
+  template <int s>
+  using TableauMatrix = std::array<std::array<double, s>, s>;
+
+  template <int s>
+  using TableauVector = std::array<double, s>;
+
+  // tag for steppers taking their coefficients at runtime
+  struct DynamicTableau {};
+
+  namespace Impl {
+
+    template <class F, int... i>
+    void unroll(F&& f, std::integer_sequence<int, i...>)
+    {
+      (f(std::integral_constant<int, i>()), ...);
+    }
+  }
+
+  // calls f(std::integral_constant<int, i>()) for i=0,...,n-1
+  template <int n, class F>
+  void unroll(F&& f)
+  {
+    Impl::unroll(std::forward<F>(f), std::make_integer_sequence<int, n>());
+  }
+
+  // Runge-Kutta-Nyström method of order 4
+  // -------------------------------------
+  struct RKN4Tableau {
+
+    static constexpr int stages = 3;
+    static constexpr int order  = 4;
+
+    static constexpr TableauMatrix<3> A = {{
+      {0.0,     0.0, 0.0},
+      {1.0/8.0, 0.0, 0.0},
+      {0.0,     0.5, 0.0}
+    }};
+
+    static constexpr TableauVector<3> b_bar = {1.0/6.0, 1.0/3.0, 0.0};
+    static constexpr TableauVector<3> b     = {1.0/6.0, 4.0/6.0, 1.0/6.0};
+    static constexpr TableauVector<3> c     = {0.0, 0.5, 1.0};
+  };
+
+  // Runge-Kutta-Nyström method of order 5
+  // -------------------------------------
+  struct RKN5Tableau {
+
+    static constexpr int stages = 4;
+    static constexpr int order  = 5;
+
+    static constexpr TableauMatrix<4> A = {{
+      {0.0,       0.0,       0.0,      0.0},
+      {1.0/50.0,  0.0,       0.0,      0.0},
+      {-1.0/27.0, 7.0/27.0,  0.0,      0.0},
+      {3.0/10.0,  -2.0/35.0, 9.0/35.0, 0.0}
+    }};
+
+    static constexpr TableauVector<4> b_bar = {14.0/336.0, 100.0/336.0, 54.0/336.0, 0.0};
+    static constexpr TableauVector<4> b     = {14.0/336.0, 125.0/336.0, 162.0/336.0, 35.0/336.0};
+    static constexpr TableauVector<4> c     = {0.0, 1.0/5.0, 2.0/3.0, 1.0};
+  };
+
+  // Emmbeded Runge-Kutta-Nyström method of order 4 5
+  // Bettis coefficients
+  // ------------------------------------------------
+  struct BettisRKN45Tableau {
+
+    static constexpr int stages = 6;
+    static constexpr int order  = 4;
+
+    static constexpr TableauMatrix<6> A = {{
+      {0.0,       0.0,      0.0,      0.0,       0.0,      0.0},
+      {1.0/128.0, 0.0,      0.0,      0.0,       0.0,      0.0},
+      {1.0/96.0,  1.0/48.0, 0.0,      0.0,       0.0,      0.0},
+      {1.0/24.0,  0.0,      1.0/12.0, 0.0,       0.0,      0.0},
+      {9.0/128.0, 0.0,      9.0/64.0, 9.0/128.0, 0.0,      0.0},
+      {7.0/90.0,  0.0,      4.0/15.0, 1.0/15.0,  4.0/45.0, 0.0}
+    }};
+
+    static constexpr TableauVector<6> b_bar_tilde = {7.0/90.0, 0.0, 4.0/15.0, 1.0/15.0, 4.0/45.0, 0.0};
+    static constexpr TableauVector<6> b_bar       = {1.0/6.0, 0.0, 0.0, 1.0/3.0, 0.0, 0.0};
+    static constexpr TableauVector<6> b_tilde     = {7.0/90.0, 0.0, 16.0/45.0, 2.0/15.0, 16.0/45.0, 7.0/90.0};
+    static constexpr TableauVector<6> b           = {0.0, 0.0, 2.0/3.0, -1.0/3.0, 2.0/3.0, 0.0};
+    static constexpr TableauVector<6> c           = {0.0, 1.0/8.0, 1.0/4.0, 1.0/2.0, 3.0/4.0, 1.0};
+  };
+
+  // Emmbeded Runge-Kutta-Nyström method of order 6 5
+  // Domain-Prince coefficients
+  // ------------------------------------------------
+  struct DPRKN64Tableau {
+
+    static constexpr int stages = 6;
+    static constexpr int order  = 4;
+
+    static constexpr TableauMatrix<6> A = {{
+      {0.0,                0.0,               0.0,              0.0,              0.0,             0.0},
+      {1.0/200.0,          0.0,               0.0,              0.0,              0.0,             0.0},
+      {-1.0/2200.0,        1.0/22.0,          0.0,              0.0,              0.0,             0.0},
+      {637.0/6600.0,       -7.0/110.0,        7.0/33.0,         0.0,              0.0,             0.0},
+      {225437.0/1968750.0, -30073.0/281250.0, 65569.0/281250.0, -9367.0/984375.0, 0.0,             0.0},
+      {151.0/2142.0,       5.0/116.0,         385.0/1368.0,     55.0/168.0,       -6250.0/28101.0, 0.0}
+    }};
+
+    static constexpr TableauVector<6> b_bar_tilde = {151.0/2142.0, 5.0/116.0, 385.0/1368.0,
+                                                     55.0/168.0, -6250.0/28101.0, 0.0};
+    static constexpr TableauVector<6> b_bar       = {1349.0/157500.0, 7873.0/50000.0, 192199.0/900000.0,
+                                                     521683.0/2100000.0, -16.0/125.0, 0.0};
+    static constexpr TableauVector<6> b_tilde     = {151.0/2142.0, 25.0/522.0, 275.0/684.0,
+                                                     275.0/252.0, -78125.0/112404.0, 1.0/12.0};
+    static constexpr TableauVector<6> b           = {1349.0/157500.0, 7873.0/45000.0, 27457.0/90000.0,
+                                                     521683.0/630000.0, -2.0/5.0, 1.0/12.0};
+    static constexpr TableauVector<6> c           = {0.0, 1.0/10.0, 3.0/10.0, 7.0/10.0, 17.0/25.0, 1.0};
+  };
+
+  // Emmbeded Runge-Kutta-Nyström method of order 8 6
+  // Domain-Prince coefficients
+  // ------------------------------------------------
+  struct DPRKN86Tableau {
+
+    static constexpr int stages = 9;
+    static constexpr int order  = 6;
+
+    static constexpr TableauMatrix<9> A = {{
+      {0.0,                       0.0,                    0.0,                     0.0,                    0.0,            0.0,           0.0,           0.0, 0.0},
+      {1.0/800.0,                 0.0,                    0.0,                     0.0,                    0.0,            0.0,           0.0,           0.0, 0.0},
+      {1.0/600.0,                 1.0/300.0,              0.0,                     0.0,                    0.0,            0.0,           0.0,           0.0, 0.0},
+      {9.0/200.0,                 -9.0/100.0,             9.0/100.0,               0.0,                    0.0,            0.0,           0.0,           0.0, 0.0},
+      {-66701.0/197352.0,         28325.0/32892.0,        -2665.0/5482.0,          2170.0/24669.0,         0.0,            0.0,           0.0,           0.0, 0.0},
+      {227015747.0/304251000.0,   -54897451.0/30425100.0, 12942349.0/10141700.0,   -9499.0/304251.0,       539.0/9250.0,   0.0,           0.0,           0.0, 0.0},
+      {-1131891597.0/901789000.0, 41964921.0/12882700.0,  -6663147.0/3320675.0,    270954.0/644135.0,      -108.0/5875.0,  114.0/1645.0,  0.0,           0.0, 0.0},
+      {13836959.0/3667458.0,      -17731450.0/1833729.0,  1063919505.0/156478208.0, -33213845.0/39119552.0, 13335.0/28544.0, -705.0/14272.0, 1645.0/57088.0, 0.0, 0.0},
+      {223.0/7938.0,              0.0,                    1175.0/8064.0,           925.0/6048.0,           41.0/448.0,     925.0/14112.0, 1175.0/72576.0, 0.0, 0.0}
+    }};
+
+    static constexpr TableauVector<9> b_bar_tilde = {223.0/7938.0, 0.0, 1175.0/8064.0, 925.0/6048.0, 41.0/448.0,
+                                                     925.0/14112.0, 1175.0/72576.0, 0.0, 0.0};
+    static constexpr TableauVector<9> b_bar       = {7987313.0/109941300.0, 0.0, 1610737.0/44674560.0, 10023263.0/33505920.0,
+                                                     -497221.0/12409600.0, 10023263.0/78180480.0, 1610737.0/402071040.0, 0.0, 0.0};
+    static constexpr TableauVector<9> b_tilde     = {223.0/7938.0, 0.0, 5875.0/36288.0, 4625.0/21168.0, 41.0/224.0,
+                                                     4625.0/21168.0, 5875.0/36288.0, 223.0/7938.0, 0.0};
+    static constexpr TableauVector<9> b           = {7987313.0/109941300.0, 0.0, 1610737.0/40207104.0, 10023263.0/23454144.0,
+                                                     -497221.0/6204800.0, 10023263.0/23454144.0, 1610737.0/402071040.0,
+                                                     -4251941.0/54970650.0, 3.0/20.0};
+    static constexpr TableauVector<9> c           = {0.0, 1.0/20.0, 1.0/10.0, 3.0/10.0, 1.0/2.0, 7.0/10.0, 9.0/10.0, 1.0, 1.0};
+  };
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define TIME_STEP_CONTROLLER_HH
 
 #include <math.h>
+#include <string>
 
 namespace Dune {
 	class TimeStepController 
@@ -14,6 +15,28 @@ namespace Dune {
 				return dt_;
 			}
 
+			// current time, advanced by the steppers after each accepted step
+			double time() const {
+				return time_;
+			}
+
+			void advance(double dt) {
+				time_ += dt;
+			}
+
+			// checkpoint/restart, see utilities/checkpoint.hh
+			template <class Writer>
+			void save(Writer& writer, const std::string& prefix = "controller") const {
+				writer.write(prefix + ".time", time_);
+				writer.write(prefix + ".dt", dt_);
+			}
+
+			template <class Reader>
+			void restore(Reader& reader, const std::string& prefix = "controller") {
+				reader.read(prefix + ".time", time_);
+				reader.read(prefix + ".dt", dt_);
+			}
+
 		protected:
 			double dt_;
 			double time_;
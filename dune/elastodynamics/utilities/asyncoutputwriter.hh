@@ -0,0 +1,220 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef ASYNC_OUTPUT_WRITER_HH
+#define ASYNC_OUTPUT_WRITER_HH
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+namespace Dune::Elastodynamics {
+
+  // Asynchronous output writer
+  // --------------------------
+  // write() copies the solution into a free buffer and appends it to a bounded
+  // queue, a background thread copies the oldest snapshot into the vector the
+  // output functions are bound to and calls the write callback (e.g.
+  // VTKSequenceWriter::write). The queue absorbs bursts, as long as the disk
+  // keeps up on average no frame is lost and the time loop never waits. Memory
+  // is bounded by capacity+1 copies of the vector. What happens to a new
+  // snapshot while the queue is full is chosen by the overflow policy:
+  // - block: write() waits until the oldest one is taken, every frame is written
+  // - drop:  the oldest queued one is replaced with a warning, the time loop
+  //          never waits for the disk, dropped() counts the lost frames
+  // An exception of the callback stops the output, later snapshots are
+  // discarded and finish() rethrows it.
+  enum class OutputOverflow { block, drop };
+
+  template <class VectorType>
+  class AsyncOutputWriter {
+
+    private:
+
+      VectorType& target_;
+      std::function<void(double)> callback_;
+      OutputOverflow overflow_;
+      std::size_t capacity_;
+
+      std::vector<std::unique_ptr<VectorType>> free_;
+      std::deque<std::pair<double, std::unique_ptr<VectorType>>> queue_;
+      bool stop_ = false, finished_ = false;
+      std::exception_ptr error_;
+      int dropped_ = 0;
+
+      int interval_ = 1, step_ = 0;
+      double deltaT_ = 0.0, nextTime_ = 0.0;
+      bool started_ = false;
+
+      std::mutex mutex_;
+      std::condition_variable condition_, taken_;
+      std::thread thread_;
+
+      bool due(double t)
+      {
+        if(deltaT_ > 0.0) {
+          if(started_ and t < nextTime_*(1.0-1e-12))
+            return false;
+          if(!started_)
+            nextTime_ = t;
+          while(nextTime_ <= t*(1.0+1e-12))
+            nextTime_ += deltaT_;
+          started_ = true;
+          return true;
+        }
+        return (step_++ % interval_) == 0;
+      }
+
+      void run()
+      {
+        while(true) {
+          double t;
+          std::unique_ptr<VectorType> writing;
+          {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]{ return !queue_.empty() or stop_; });
+            if(queue_.empty())
+              return;
+            t = queue_.front().first;
+            writing = std::move(queue_.front().second);
+            queue_.pop_front();
+          }
+          taken_.notify_one();
+
+          try {
+            target_ = *writing;
+            callback_(t);
+          }
+          catch(...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+            for(auto& entry : queue_)
+              free_.push_back(std::move(entry.second));
+            queue_.clear();
+            free_.push_back(std::move(writing));
+            taken_.notify_one();
+            return;
+          }
+
+          std::lock_guard<std::mutex> lock(mutex_);
+          free_.push_back(std::move(writing));
+        }
+      }
+
+    public:
+
+      // target is the vector the output functions are bound to, it is only touched
+      // by the background thread, capacity is the number of queued snapshots
+      AsyncOutputWriter(VectorType& target, std::function<void(double)> callback,
+                        OutputOverflow overflow = OutputOverflow::block,
+                        std::size_t capacity = 4)
+        : target_(target)
+        , callback_(callback)
+        , overflow_(overflow)
+        , capacity_(std::max<std::size_t>(capacity, 1))
+      {
+        // one more for the snapshot being written
+        for(std::size_t i=0; i<=capacity_; i++)
+          free_.push_back(std::make_unique<VectorType>(target));
+        thread_ = std::thread(&AsyncOutputWriter::run, this);
+      }
+
+      ~AsyncOutputWriter()
+      {
+        try {
+          finish();
+        }
+        catch(const std::exception& e) {
+          std::cerr << "AsyncOutputWriter: " << e.what() << std::endl;
+        }
+        catch(...) {
+          std::cerr << "AsyncOutputWriter: output stopped by an exception" << std::endl;
+        }
+      }
+
+      // write every n-th call of write()
+      void everyNSteps(int n)
+      {
+        interval_ = n;
+        deltaT_ = 0.0;
+      }
+
+      // write whenever dt of simulated time has passed
+      void everyDeltaT(double dt)
+      {
+        deltaT_ = dt;
+      }
+
+      void write(const VectorType& vector, double t)
+      {
+        if(finished_)
+          DUNE_THROW(Dune::InvalidStateException, "AsyncOutputWriter: write() after finish()");
+        if(!due(t))
+          return;
+
+        std::unique_ptr<VectorType> buffer;
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          if(queue_.size() == capacity_) {
+            if(overflow_ == OutputOverflow::block)
+              taken_.wait(lock, [this]{ return queue_.size() < capacity_ or error_; });
+            else {
+              dropped_++;
+              std::cerr << "AsyncOutputWriter: dropped the snapshot of t = " << queue_.front().first << std::endl;
+              buffer = std::move(queue_.front().second);
+              queue_.pop_front();
+            }
+          }
+          if(error_)
+            return;
+          if(!buffer) {
+            buffer = std::move(free_.back());
+            free_.pop_back();
+          }
+        }
+
+        // the copy does not hold the lock, the buffer belongs to this thread
+        *buffer = vector;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          queue_.emplace_back(t, std::move(buffer));
+        }
+        condition_.notify_one();
+      }
+
+      // number of snapshots replaced before they could be written (drop policy)
+      int dropped() const { return dropped_; }
+
+      // writes the queued snapshots and stops the background thread, rethrows
+      // an exception of the callback
+      void finish()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          stop_ = true;
+          finished_ = true;
+        }
+        condition_.notify_one();
+        if(thread_.joinable())
+          thread_.join();
+
+        if(error_) {
+          std::exception_ptr error = error_;
+          error_ = nullptr;
+          std::rethrow_exception(error);
+        }
+      }
+  };
+}
+
+#endif
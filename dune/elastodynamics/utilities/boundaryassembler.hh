@@ -35,7 +35,11 @@ namespace Dune::Elastodynamics {
  
           for( int i=0; i<localView.size(); i++) {
             auto row = localView.index(i);
-            b[row[0]][row[1]] = localVector[i];
+            // loads accumulate on dofs shared by several faces, values are set
+            if constexpr (LocalBoundaryAssemblerType::additive)
+              b[row[0]][row[1]] += localVector[i];
+            else
+              b[row[0]][row[1]] = localVector[i];
           }
         }
       }
@@ -0,0 +1,141 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef BOUNDARY_DOFS_HH
+#define BOUNDARY_DOFS_HH
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <dune/geometry/referenceelements.hh>
+#include <dune/grid/common/partitionset.hh>
+
+namespace Dune::Elastodynamics {
+
+  // Sorted block indices of all dofs on the boundary faces of each boundary id
+  // (the physical group of the boundary segment read by the GmshReader). Built once
+  // by one pass over the boundary intersections, it covers every dof of a face,
+  // also the edge, face and higher-order ones, vertexDofs only the vertex ones.
+  // On a distributed grid only the interior elements are visited, a copy of a
+  // dof whose elements touch the face only at a vertex or edge is found by
+  // passing the DofCommunicator, which OR-reduces the sets over the copies.
+  template<class Basis>
+  class BoundaryDofs {
+
+    private:
+
+      std::map<int, std::vector<std::size_t>> dofs_, vertexDofs_;
+      const std::vector<std::size_t> empty_;
+
+      static void sortUnique(std::vector<std::size_t>& indices)
+      {
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+      }
+
+      // a dof belongs to the set if any copy does, collective
+      template<class Communicator>
+      static void reduce(std::map<int, std::vector<std::size_t>>& sets, int id,
+                         Communicator& communicator, std::size_t size)
+      {
+        using Vector = typename Communicator::VectorType;
+        Vector flags(size);
+        flags = 0.0;
+        auto set = sets.find(id);
+        if(set != sets.end())
+          for(auto i : set->second)
+            flags[i] = 1.0;
+        communicator.add(flags);
+
+        std::vector<std::size_t> indices;
+        for(std::size_t i=0; i<size; i++)
+          if(flags[i][0] > 0.0)
+            indices.push_back(i);
+        if(!indices.empty())
+          sets[id] = std::move(indices);
+      }
+
+    public:
+
+      BoundaryDofs(const Basis& basis, const std::vector<int>& boundaryIndex)
+      {
+        auto gridView = basis.gridView();
+        static const int dim = Basis::GridView::dimension;
+        auto localView = basis.localView();
+
+        for( const auto& element : elements(gridView, Dune::Partitions::interior)) {
+
+          if(!element.hasBoundaryIntersections())
+            continue;
+
+          localView.bind(element);
+          const auto& node = localView.tree().child(0);
+          const auto& coefficients = node.finiteElement().localCoefficients();
+          auto ref = referenceElement<double, dim>(element.type());
+
+          for( const auto& isect : intersections(gridView, element)) {
+            if(!isect.boundary())
+              continue;
+
+            const int id = boundaryIndex[isect.boundarySegmentIndex()];
+            const int face = isect.indexInInside();
+            auto& dofs = dofs_[id];
+            auto& vertexDofs = vertexDofs_[id];
+
+            for( std::size_t i=0; i<node.size(); i++) {
+              const auto& key = coefficients.localKey(i);
+              if(key.codim() == 0 or !ref.subEntities(face, 1, key.codim()).contains(key.subEntity()))
+                continue;
+              const auto index = localView.index(node.localIndex(i))[0];
+              dofs.push_back(index);
+              if(key.codim() == dim)
+                vertexDofs.push_back(index);
+            }
+          }
+        }
+
+        for( auto& entry : dofs_)
+          sortUnique(entry.second);
+        for( auto& entry : vertexDofs_)
+          sortUnique(entry.second);
+      }
+
+      // distributed grid, the sets agree on all copies of a dof
+      template<class Communicator>
+      BoundaryDofs(const Basis& basis, const std::vector<int>& boundaryIndex, Communicator& communicator)
+        : BoundaryDofs(basis, boundaryIndex)
+      {
+        int maxId = dofs_.empty() ? -1 : dofs_.rbegin()->first;
+        maxId = basis.gridView().comm().max(maxId);
+        for(int id=0; id<=maxId; id++) {
+          reduce(dofs_, id, communicator, basis.size());
+          reduce(vertexDofs_, id, communicator, basis.size());
+        }
+      }
+
+      // all boundary ids found on the grid
+      std::vector<int> ids() const
+      {
+        std::vector<int> ids;
+        for( const auto& entry : dofs_)
+          ids.push_back(entry.first);
+        return ids;
+      }
+
+      const std::vector<std::size_t>& dofs(int id) const
+      {
+        auto it = dofs_.find(id);
+        return it == dofs_.end() ? empty_ : it->second;
+      }
+
+      const std::vector<std::size_t>& vertexDofs(int id) const
+      {
+        auto it = vertexDofs_.find(id);
+        return it == vertexDofs_.end() ? empty_ : it->second;
+      }
+  };
+}
+
+#endif
@@ -4,6 +4,13 @@
 #ifndef BOUNDARY_INDEX_BC_ASSEMBLER_HH
 #define BOUNDARY_INDEX_BC_ASSEMBLER_HH
 
+#include <memory>
+#include <vector>
+
+#include <dune/elastodynamics/utilities/boundarydofs.hh>
+#include <dune/elastodynamics/utilities/dirichletelimination.hh>
+#include <dune/elastodynamics/utilities/patchload.hh>
+
 namespace Dune::Elastodynamics {
 
   template<class Basis>
@@ -13,89 +20,45 @@ namespace Dune::Elastodynamics {
 
       const Basis& basis_;
       const std::vector<int> boundaryIndex_;
+      const BoundaryDofs<Basis> boundaryDofs_;
+
+      // built on first use, the traction setup and the collective sum of the
+      // patch area are only paid by callers of assembleForce/patchLoad
+      mutable std::unique_ptr<const PatchLoad<Basis>> load_;
       
+      // rows in notOwned get a zero instead of an identity diagonal, so the
+      // additive distributed matrix sums up to the identity row
       template<class MatrixType>
-      void addMatrixBC(MatrixType& matrix) {
-      
-        auto gridView = basis_.gridView();
-      
-        for( const auto& element : elements(gridView)) {
-        
-          auto localView = basis_.localView();
-          const auto &indexSet = gridView.indexSet();
-          static const int dim = gridView.dimension;
-          
-		  for( const auto& isect : intersections(gridView, element)) {
-            if(isect.boundary()) {
-		       
-		       auto ref = referenceElement<double, dim>(element.type());  
-		       
-		       switch(boundaryIndex_[isect.boundarySegmentIndex()]) {
-		        case 0: // no boundary condition applied
-		          break;
-		        case 1: // set dirichlet BC
-		          for(int i=0; i<ref.size(isect.indexInInside(), 1, dim); i++) {         
-                    int row = indexSet.subIndex(element, ref.subEntity(isect.indexInInside(), 1, i, dim), dim);
-                    FieldMatrix<double, dim, dim> I = ScaledIdentityMatrix<double, dim>(1.0);
-                    FieldMatrix<double, dim, dim> O(0.0);
-                    auto rowBegin = matrix[row].begin();
-                    auto rowEnd = matrix[row].end();
-                    for(; rowBegin!=rowEnd; rowBegin++) {
-                      *rowBegin = (row==rowBegin.index()) ? I : O;
-                    }
-                  }
-		          break;
-		        case 2: // force on area
-		          break;
-		        case 3: // something else
-		          break;
-		        // ....
-		      }
-		    }
-		  }
-	    }
+      void addMatrixBC(MatrixType& matrix, const std::vector<std::size_t>& notOwned = {}) {
+
+        std::vector<bool> owned(notOwned.empty() ? 0 : matrix.N(), true);
+        for(auto i : notOwned)
+          owned[i] = false;
+
+        using Block = typename MatrixType::block_type;
+        Block I(0.0), O(0.0);
+        for(int k=0; k<Block::rows; k++)
+          I[k][k] = 1.0;
+
+        // id 1: dirichlet BC on all dofs of the faces
+        for(auto row : boundaryDofs_.dofs(1)) {
+          auto rowEnd = matrix[row].end();
+          for(auto rowBegin = matrix[row].begin(); rowBegin!=rowEnd; rowBegin++) {
+            *rowBegin = (row==rowBegin.index() and (owned.empty() or owned[row])) ? I : O;
+          }
+        }
       }
       
       template<class VectorType, class Force>
       void addVectorBC(VectorType& vector, Force& force) {
       
-        auto gridView = basis_.gridView();
-      
-        for( const auto& element : elements(gridView)) {
-        
-          auto localView = basis_.localView();
-          const auto &indexSet = gridView.indexSet();
-          static const int dim = gridView.dimension;
-          
-		  for( const auto& isect : intersections(gridView, element)) {
-            if(isect.boundary()) {
-		       
-		       auto ref = referenceElement<double, dim>(element.type());  
-		       
-		       switch(boundaryIndex_[isect.boundarySegmentIndex()]) {
-		        case 0: // no boundary condition applied
-		          break;
-		        case 1: // set fixed wall
-		          for(int i=0; i<ref.size(isect.indexInInside(), 1, dim); i++) {         
-                    int row = indexSet.subIndex(element, ref.subEntity(isect.indexInInside(), 1, i, dim), dim);
-                    FieldVector<double, dim> O(0.0);
-                    vector[row] = O;
-                  }
-		          break;
-		        case 2: // force on area
-		          for(int i=0; i<ref.size(isect.indexInInside(), 1, dim); i++) {         
-                    int row = indexSet.subIndex(element, ref.subEntity(isect.indexInInside(), 1, i, dim), dim);
-                    FieldVector<double, dim> O(0.0);
-                    vector[row] = force;
-                  }
-		          break;
-		        case 3: // something else
-		          break;
-		        // ....
-		      }
-		    }
-		  }
-	    }
+        // id 1: fixed wall
+        for(auto row : boundaryDofs_.dofs(1))
+          vector[row] = 0.0;
+
+        // id 2: nodal force on every vertex
+        for(auto row : boundaryDofs_.vertexDofs(2))
+          vector[row] = force;
       }
       
     public:
@@ -103,7 +66,23 @@ namespace Dune::Elastodynamics {
       BoundaryIndexBCAssembler(const Basis& basis, const std::vector<int> boundaryIndex)
         : basis_(basis)
         , boundaryIndex_(boundaryIndex)
+        , boundaryDofs_(basis, boundaryIndex)
       {}
+
+      // distributed grid, the boundary dofs are reduced over the copies, so
+      // every copy of a dof on a Dirichlet face gets its (owner-based) row
+      template<class Communicator>
+      BoundaryIndexBCAssembler(const Basis& basis, const std::vector<int> boundaryIndex,
+                               Communicator& communicator)
+        : basis_(basis)
+        , boundaryIndex_(boundaryIndex)
+        , boundaryDofs_(basis, boundaryIndex, communicator)
+      {}
+
+      // the precomputed dof index sets per boundary id
+      const BoundaryDofs<Basis>& boundaryDofs() const {
+        return boundaryDofs_;
+      }
       
       template<class MatrixType>
       void assembleMatrix(MatrixType& matrix) {
@@ -111,10 +90,46 @@ namespace Dune::Elastodynamics {
       }
       
       
+      // symmetric elimination of the dirichlet dofs, the returned object lifts
+      // prescribed values into the right hand side
+      template<class MatrixType>
+      SymmetricDirichletElimination<MatrixType> assembleMatrixSymmetric(MatrixType& matrix) {
+        SymmetricDirichletElimination<MatrixType> elimination(boundaryDofs_.dofs(1));
+        elimination.eliminate(matrix);
+        return elimination;
+      }
+      
+      
+      // for the additive matrices of the DistributedOperatorAssembler
+      template<class MatrixType, class Communicator>
+      void assembleMatrix(MatrixType& matrix, const Communicator& communicator) {
+        addMatrixBC(matrix, communicator.notOwned());
+      }
+      
+      
       template<class VectorType, class Force>
       void assembleVector(VectorType& vector, Force& force) {
         addVectorBC(vector, force);
       }
+
+
+      // id 2: total force distributed consistently over the faces, the load
+      // vector can be rescaled at runtime with patchLoad().addForce. The
+      // clamped rows are zeroed after the load, a patch touching id 1 loses
+      // the share of the shared dofs to the support
+      template<class VectorType, class Force>
+      void assembleForce(VectorType& vector, const Force& force) {
+        patchLoad().addForce(vector, force);
+        for(auto row : boundaryDofs_.dofs(1))
+          vector[row] = 0.0;
+      }
+
+      // the first call is collective in parallel
+      const PatchLoad<Basis>& patchLoad() const {
+        if(!load_)
+          load_ = std::make_unique<const PatchLoad<Basis>>(basis_, boundaryIndex_, 2);
+        return *load_;
+      }
     
   }; 
 }     
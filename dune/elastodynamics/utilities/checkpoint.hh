@@ -0,0 +1,206 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef CHECKPOINT_HH
+#define CHECKPOINT_HH
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+namespace Dune::Elastodynamics {
+
+  // Binary checkpoint format
+  // ------------------------
+  // file header:   char magic[8], uint32 version, uint32 padding
+  // every record:  char name[48], uint64 entries, uint64 blockSize, double payload[entries]
+  // all payloads are raw doubles on 8 byte boundaries, so the file can be mapped
+  // into memory directly
+  namespace Checkpoint {
+
+    inline constexpr char magic[8] = {'D', 'E', 'L', 'A', 'S', 'T', 'C', 'P'};
+    inline constexpr std::uint32_t version = 1;
+    inline constexpr std::size_t nameLength = 48;
+
+    struct RecordHeader {
+      char name[nameLength];
+      std::uint64_t entries;
+      std::uint64_t blockSize;
+    };
+  }
+
+  class CheckpointWriter {
+
+    private:
+
+      std::ofstream file_;
+      std::string filename_;
+
+      void writeBytes(const char* data, std::size_t bytes)
+      {
+        file_.write(data, bytes);
+        if(!file_)
+          DUNE_THROW(Dune::IOError, "could not write checkpoint " << filename_);
+      }
+
+      void writeRecord(const std::string& name, const double* data,
+                       std::uint64_t entries, std::uint64_t blockSize)
+      {
+        if(name.size() >= Checkpoint::nameLength)
+          DUNE_THROW(Dune::IOError, "checkpoint record name too long: " << name);
+
+        Checkpoint::RecordHeader header;
+        std::memset(header.name, 0, Checkpoint::nameLength);
+        std::memcpy(header.name, name.data(), name.size());
+        header.entries = entries;
+        header.blockSize = blockSize;
+
+        writeBytes(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeBytes(reinterpret_cast<const char*>(data), entries*sizeof(double));
+      }
+
+    public:
+
+      CheckpointWriter(const std::string& filename)
+        : file_(filename, std::ios::binary | std::ios::trunc)
+        , filename_(filename)
+      {
+        if(!file_)
+          DUNE_THROW(Dune::IOError, "could not open checkpoint " << filename);
+
+        std::uint32_t padding = 0;
+        writeBytes(Checkpoint::magic, sizeof(Checkpoint::magic));
+        writeBytes(reinterpret_cast<const char*>(&Checkpoint::version), sizeof(std::uint32_t));
+        writeBytes(reinterpret_cast<const char*>(&padding), sizeof(std::uint32_t));
+      }
+
+      void write(const std::string& name, double value)
+      {
+        writeRecord(name, &value, 1, 1);
+      }
+
+      void write(const std::string& name, const std::vector<double>& values)
+      {
+        writeRecord(name, values.data(), values.size(), 1);
+      }
+
+      // block vectors of FieldVector<double, n> are stored as their raw payload
+      template <class BlockVectorType>
+      void write(const std::string& name, const BlockVectorType& vector)
+      {
+        using Block = typename BlockVectorType::block_type;
+        static_assert(sizeof(Block) == Block::dimension*sizeof(double), "blocks have to be dense doubles");
+
+        const double* data = vector.size() > 0 ? &vector[0][0] : nullptr;
+        writeRecord(name, data, vector.size()*Block::dimension, Block::dimension);
+      }
+
+      // the data reaches the file only here, a checkpoint that was not closed
+      // (e.g. left by an exception) must not be trusted
+      void close()
+      {
+        file_.close();
+        if(!file_)
+          DUNE_THROW(Dune::IOError, "could not write checkpoint " << filename_);
+      }
+  };
+
+  class CheckpointReader {
+
+    private:
+
+      std::ifstream file_;
+      std::map<std::string, std::pair<std::streamoff, Checkpoint::RecordHeader>> records_;
+
+      const Checkpoint::RecordHeader& seek(const std::string& name)
+      {
+        auto record = records_.find(name);
+        if(record == records_.end())
+          DUNE_THROW(Dune::IOError, "checkpoint record " << name << " not found");
+
+        file_.seekg(record->second.first);
+        return record->second.second;
+      }
+
+      // a truncated payload fails the stream
+      void readBytes(const std::string& name, char* data, std::size_t bytes)
+      {
+        file_.read(data, bytes);
+        if(!file_) {
+          file_.clear();
+          DUNE_THROW(Dune::IOError, "could not read checkpoint record " << name);
+        }
+      }
+
+    public:
+
+      CheckpointReader(const std::string& filename)
+        : file_(filename, std::ios::binary)
+      {
+        if(!file_)
+          DUNE_THROW(Dune::IOError, "could not open checkpoint " << filename);
+
+        char magic[8];
+        std::uint32_t version, padding;
+        file_.read(magic, sizeof(magic));
+        file_.read(reinterpret_cast<char*>(&version), sizeof(std::uint32_t));
+        file_.read(reinterpret_cast<char*>(&padding), sizeof(std::uint32_t));
+
+        if(!file_ or std::memcmp(magic, Checkpoint::magic, sizeof(magic)) != 0)
+          DUNE_THROW(Dune::IOError, filename << " is not a checkpoint");
+        if(version != Checkpoint::version)
+          DUNE_THROW(Dune::IOError, "checkpoint version " << version << " is not supported");
+
+        // index the records, payloads are skipped
+        Checkpoint::RecordHeader header;
+        while(file_.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+          header.name[Checkpoint::nameLength-1] = '\0';
+          records_[header.name] = {file_.tellg(), header};
+          file_.seekg(header.entries*sizeof(double), std::ios::cur);
+        }
+        file_.clear();
+      }
+
+      bool contains(const std::string& name) const
+      {
+        return records_.count(name) > 0;
+      }
+
+      void read(const std::string& name, double& value)
+      {
+        const auto& header = seek(name);
+        if(header.entries != 1)
+          DUNE_THROW(Dune::IOError, "checkpoint record " << name << " is not a scalar");
+        readBytes(name, reinterpret_cast<char*>(&value), sizeof(double));
+      }
+
+      void read(const std::string& name, std::vector<double>& values)
+      {
+        const auto& header = seek(name);
+        values.resize(header.entries);
+        readBytes(name, reinterpret_cast<char*>(values.data()), header.entries*sizeof(double));
+      }
+
+      template <class BlockVectorType>
+      void read(const std::string& name, BlockVectorType& vector)
+      {
+        using Block = typename BlockVectorType::block_type;
+        static_assert(sizeof(Block) == Block::dimension*sizeof(double), "blocks have to be dense doubles");
+
+        const auto& header = seek(name);
+        if(header.blockSize != Block::dimension)
+          DUNE_THROW(Dune::IOError, "checkpoint record " << name << " has block size " << header.blockSize);
+
+        vector.resize(header.entries/Block::dimension);
+        if(header.entries > 0)
+          readBytes(name, reinterpret_cast<char*>(&vector[0][0]), header.entries*sizeof(double));
+      }
+  };
+}
+
+#endif
@@ -16,6 +16,7 @@ namespace Dune::Elastodynamics {
     public:
 
       typedef typename Dune::BlockVector<Dune::FieldVector<double, 1>> LocalVector;
+      static constexpr bool additive = false;
       
       DirichletBoundaryAssembler(double value)
         : value_(value)
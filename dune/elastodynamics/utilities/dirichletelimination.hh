@@ -0,0 +1,92 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DIRICHLET_ELIMINATION_HH
+#define DIRICHLET_ELIMINATION_HH
+
+#include <vector>
+
+namespace Dune::Elastodynamics {
+
+  // Symmetric elimination of Dirichlet dofs: rows and columns of the constrained
+  // dofs are zeroed, the diagonal is the identity, so an SPD matrix stays SPD and
+  // CG/AMG can be used. The removed column entries A_fd are kept (found through
+  // the row of d, the BCRS pattern is symmetric), lift() moves them to the right
+  // hand side for any prescribed values g in O(boundary couplings):
+  // b_f -= A_fd g_d, b_d = g_d
+  template<class MatrixType>
+  class SymmetricDirichletElimination {
+
+    private:
+
+      using Block = typename MatrixType::block_type;
+
+      struct Coupling {
+        std::size_t row, col;
+        Block value;
+      };
+
+      std::vector<std::size_t> constrained_;
+      std::vector<Coupling> couplings_;
+
+    public:
+
+      SymmetricDirichletElimination(const std::vector<std::size_t>& constrained)
+        : constrained_(constrained)
+      {}
+
+      // rows in notOwned get a zero diagonal (additive distributed matrices)
+      void eliminate(MatrixType& matrix, const std::vector<std::size_t>& notOwned = {})
+      {
+        std::vector<bool> isConstrained(matrix.N(), false), owned(matrix.N(), true);
+        for(auto d : constrained_)
+          isConstrained[d] = true;
+        for(auto i : notOwned)
+          owned[i] = false;
+
+        Block I(0.0);
+        for(int k=0; k<Block::rows; k++)
+          I[k][k] = 1.0;
+
+        couplings_.clear();
+        for(auto d : constrained_) {
+          auto rowEnd = matrix[d].end();
+          for(auto it = matrix[d].begin(); it != rowEnd; ++it) {
+            const auto f = it.index();
+            if(f == d)
+              *it = owned[d] ? I : Block(0.0);
+            else {
+              if(!isConstrained[f]) {
+                couplings_.push_back({f, d, matrix[f][d]});
+                matrix[f][d] = 0.0;
+              }
+              *it = 0.0;
+            }
+          }
+        }
+      }
+
+      // b_f -= A_fd g_d, b_d = g_d
+      template<class VectorType>
+      void lift(VectorType& b, const VectorType& g) const
+      {
+        for(const auto& coupling : couplings_)
+          coupling.value.mmv(g[coupling.col], b[coupling.row]);
+        for(auto d : constrained_)
+          b[d] = g[d];
+      }
+
+      // homogeneous values, b_d = 0
+      template<class VectorType>
+      void lift(VectorType& b) const
+      {
+        for(auto d : constrained_)
+          b[d] = 0.0;
+      }
+
+      const std::vector<std::size_t>& constrained() const
+      { return constrained_; }
+  };
+}
+
+#endif
@@ -16,6 +16,7 @@ namespace Dune::Elastodynamics {
     public:
 
       typedef typename Dune::BlockVector<Dune::FieldVector<double, 1>> LocalVector;
+      static constexpr bool additive = true;
       
       NeumannBoundaryAssembler(const Function& neumannFunction)
         : neumannFunction_(neumannFunction)
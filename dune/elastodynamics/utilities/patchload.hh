@@ -0,0 +1,81 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef PATCH_LOAD_HH
+#define PATCH_LOAD_HH
+
+#include <vector>
+
+#include <dune/elastodynamics/utilities/tractionassembler.hh>
+
+namespace Dune::Elastodynamics {
+
+  // Consistent nodal loads of a boundary patch (all faces of one boundary id).
+  // The weights are integrated once with the face quadrature:
+  //   total force F:  b_d += F int phi_d / |patch|
+  //   pressure p:     b_d += p int -phi_d n
+  // so changing the magnitude at runtime is one scaled axpy on the patch dofs.
+  // The pressure is a dead load on the normals of the undeformed patch, there
+  // is no follower update with the displacement.
+  template<class Basis>
+  class PatchLoad {
+
+    public:
+
+      using Range = typename TractionAssembler<Basis>::Range;
+
+    private:
+
+      std::vector<std::size_t> dofs_;
+      std::vector<double> forceWeights_;
+      std::vector<Range> pressureWeights_;
+      double area_;
+
+    public:
+
+      PatchLoad(const Basis& basis, const std::vector<int>& boundaryIndex,
+                int id, int quadOrder = -1)
+      {
+        TractionAssembler<Basis> traction(basis, boundaryIndex, id, quadOrder);
+        dofs_ = traction.dofs();
+        area_ = basis.gridView().comm().sum(traction.area());
+
+        std::vector<Range> result;
+        Range e(0.0);
+        e[0] = 1.0;
+        traction.integrate([&](std::size_t) { return e; }, result);
+        for(const auto& value : result)
+          forceWeights_.push_back(area_ > 0.0 ? value[0]/area_ : 0.0);
+
+        const auto& normals = traction.normals();
+        traction.integrate([&](std::size_t q) {
+          Range t = normals[q];
+          t *= -1.0;
+          return t;
+        }, pressureWeights_);
+      }
+
+      // measure of the patch, summed over all ranks
+      double area() const { return area_; }
+
+      const std::vector<std::size_t>& dofs() const { return dofs_; }
+
+      // b += F w, the resultant of the distributed load is F
+      template<class VectorType>
+      void addForce(VectorType& b, const Range& force) const
+      {
+        for(std::size_t k=0; k<dofs_.size(); k++)
+          b[dofs_[k]].axpy(forceWeights_[k], force);
+      }
+
+      // b += p W, uniform pressure against the outer normal
+      template<class VectorType>
+      void addPressure(VectorType& b, double pressure) const
+      {
+        for(std::size_t k=0; k<dofs_.size(); k++)
+          b[dofs_[k]].axpy(pressure, pressureWeights_[k]);
+      }
+  };
+}
+
+#endif
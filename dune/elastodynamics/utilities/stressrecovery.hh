@@ -0,0 +1,339 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef STRESS_RECOVERY_HH
+#define STRESS_RECOVERY_HH
+
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/geometry/quadraturerules.hh>
+#include <dune/elastodynamics/assemblers/elasticitykernels.hh>
+#include <dune/elastodynamics/assemblers/materialtable.hh>
+#include <dune/elastodynamics/assemblers/symmetrictensor.hh>
+
+namespace Dune::Elastodynamics {
+
+  // von Mises stress, in 2D with the out-of-plane stress szz: 0 for plane stress,
+  // nu (sxx + syy) for plane strain
+  template<int dim>
+  double vonMises(const SymmetricTensor<dim>& s, double szz = 0.0)
+  {
+    if constexpr (dim == 2)
+      return std::sqrt(0.5*((s(0,0)-s(1,1))*(s(0,0)-s(1,1)) + (s(1,1)-szz)*(s(1,1)-szz)
+                            + (szz-s(0,0))*(szz-s(0,0)))
+                       + 3.0*s(0,1)*s(0,1));
+    else
+      return std::sqrt(0.5*((s(0,0)-s(1,1))*(s(0,0)-s(1,1)) + (s(1,1)-s(2,2))*(s(1,1)-s(2,2))
+                            + (s(2,2)-s(0,0))*(s(2,2)-s(0,0)))
+                       + 3.0*(s(0,1)*s(0,1) + s(0,2)*s(0,2) + s(1,2)*s(1,2)));
+  }
+
+  // Strain and stress recovery from a displacement of a power<dim>(lagrange<p>())
+  // basis with the stress kernels of the StiffnessAssembler. The setup pass caches
+  // the global shape function gradients of every element at its quadrature points
+  // and at its Lagrange nodes, a recovery is then a loop over these tables,
+  // parallel over the elements (OpenMP), without geometry or basis evaluations:
+  // - quadrature points: strain/stress per element and quadrature point
+  // - nodes: the values of the elements sharing a node are averaged, the nodal
+  //   arrays have the numbering of the scalar Lagrange basis (for the VTK output)
+  // In 2D the plane assumption and nu of each material give the out-of-plane
+  // stress of the von Mises stress, sigma_zz = nu (sigma_xx + sigma_yy) for plane
+  // strain. The recoveries only read the tables, concurrent calls are safe.
+  template<class Basis, class Kernel = IsotropicMaterial<Basis::GridView::dimension>>
+  class StressRecovery {
+
+    public:
+
+      using GridView = typename Basis::GridView;
+      static const int dim = GridView::dimension;
+      using Tensor = SymmetricTensor<dim>;
+      using Gradient = FieldVector<double, dim>;
+
+    private:
+
+      struct ElementData {
+        std::size_t dofBegin, size;        // local functions of one component
+        std::size_t quadBegin, quadPoints; // quadrature points
+        std::size_t quadGradients, nodeGradients;
+        int kernel;
+      };
+
+      std::size_t size_;
+      std::vector<ElementData> elements_;
+      std::vector<std::size_t> dofs_;
+      std::vector<Gradient> gradients_;
+      std::vector<Kernel> kernels_;
+      std::vector<double> outOfPlane_;   // per kernel: sigma_zz/(sigma_xx + sigma_yy)
+
+      // dof -> positions in dofs_ (all element copies of a node)
+      std::vector<std::size_t> nodeBegin_, nodeSlots_;
+
+      // stress and sigma_zz of one node, averaged together for the von Mises stress
+      struct PlaneStress {
+        Tensor stress;
+        double zz;
+
+        PlaneStress(double value = 0.0) : stress(value), zz(value) {}
+
+        PlaneStress& operator+=(const PlaneStress& other)
+        {
+          stress += other.stress;
+          zz += other.zz;
+          return *this;
+        }
+
+        PlaneStress& operator/=(double value)
+        {
+          stress /= value;
+          zz /= value;
+          return *this;
+        }
+      };
+
+      // kernelOf(element) returns the kernel and its out-of-plane factor
+      template<class KernelOf>
+      void setup(const Basis& basis, const KernelOf& kernelOf, int quadOrder)
+      {
+        auto gridView = basis.gridView();
+        auto localView = basis.localView();
+        std::map<const Kernel*, int> kernelIndex;
+        std::vector<FieldMatrix<double, 1, dim>> referenceGradients;
+        std::vector<FieldVector<double, dim>> nodes;
+        std::vector<double> coefficients;
+
+        for( const auto& element : elements(gridView)) {
+
+          localView.bind(element);
+          const auto& node = localView.tree().child(0);
+          const auto& localFE = node.finiteElement();
+          const auto geometry = element.geometry();
+          const int order = quadOrder < 0 ? 2*localFE.localBasis().order() : quadOrder;
+          const auto& quadRule = QuadratureRules<double, dim>::rule(element.type(), order);
+
+          ElementData data;
+          data.dofBegin = dofs_.size();
+          data.size = localFE.size();
+          data.quadPoints = quadRule.size();
+
+          const auto [kernel, factor] = kernelOf(element);
+          auto it = kernelIndex.find(kernel);
+          if(it == kernelIndex.end()) {
+            it = kernelIndex.emplace(kernel, kernels_.size()).first;
+            kernels_.push_back(*kernel);
+            outOfPlane_.push_back(factor);
+          }
+          data.kernel = it->second;
+
+          for( std::size_t i=0; i<localFE.size(); i++)
+            dofs_.push_back(localView.index(node.localIndex(i))[0]);
+
+          auto addGradients = [&](const FieldVector<double, dim>& x) {
+            const auto invJacobian = geometry.jacobianInverseTransposed(x);
+            localFE.localBasis().evaluateJacobian(x, referenceGradients);
+            for( std::size_t i=0; i<localFE.size(); i++) {
+              Gradient gradient;
+              invJacobian.mv(referenceGradients[i][0], gradient);
+              gradients_.push_back(gradient);
+            }
+          };
+
+          data.quadGradients = gradients_.size();
+          for(const auto& quadPoint : quadRule)
+            addGradients(quadPoint.position());
+
+          // the Lagrange nodes, the interpolation evaluates once at each of them
+          nodes.clear();
+          localFE.localInterpolation().interpolate([&](const FieldVector<double, dim>& x) {
+            nodes.push_back(x);
+            return 0.0;
+          }, coefficients);
+          if(nodes.size() != localFE.size())
+            DUNE_THROW(NotImplemented, "stress recovery needs a nodal (Lagrange) basis");
+
+          data.nodeGradients = gradients_.size();
+          for(const auto& x : nodes)
+            addGradients(x);
+
+          elements_.push_back(data);
+        }
+
+        std::size_t quadBegin = 0;
+        for(auto& data : elements_) {
+          data.quadBegin = quadBegin;
+          quadBegin += data.quadPoints;
+        }
+
+        // compressed dof -> slot table
+        size_ = basis.size();
+        nodeBegin_.assign(size_+1, 0);
+        for(auto dof : dofs_)
+          nodeBegin_[dof+1]++;
+        for(std::size_t i=0; i<size_; i++)
+          nodeBegin_[i+1] += nodeBegin_[i];
+        nodeSlots_.resize(dofs_.size());
+        std::vector<std::size_t> fill(nodeBegin_.begin(), nodeBegin_.end()-1);
+        for(std::size_t slot=0; slot<dofs_.size(); slot++)
+          nodeSlots_[fill[dofs_[slot]]++] = slot;
+      }
+
+      static double outOfPlane(PlaneAssumption assumption, double nu)
+      {
+        return dim == 2 and assumption == PlaneAssumption::strain ? nu : 0.0;
+      }
+
+      template<class VectorType>
+      void strain(const VectorType& u, const ElementData& data, const Gradient* gradients, Tensor& strain) const
+      {
+        FieldMatrix<double, dim, dim> G(0.0);
+        for( std::size_t i=0; i<data.size; i++) {
+          const auto& ui = u[dofs_[data.dofBegin+i]];
+          for( int k=0; k<dim; k++)
+            G[k].axpy(ui[k], gradients[i]);
+        }
+        for( int k=0; k<dim; k++) {
+          strain(k,k) = G[k][k];
+          for( int l=k+1; l<dim; l++)
+            strain(k,l) = 0.5*(G[k][l] + G[l][k]);
+        }
+      }
+
+      // evaluate at the element nodes into the slots (one per element copy of a
+      // node, local to the call), then average per dof
+      template<class VectorType, class Value, class Result>
+      void nodal(const VectorType& u, const Value& value, std::vector<Result>& result) const
+      {
+        std::vector<Result> slots(dofs_.size());
+        #pragma omp parallel for
+        for(long e=0; e<long(elements_.size()); e++) {
+          const auto& data = elements_[e];
+          Tensor epsilon;
+          for( std::size_t i=0; i<data.size; i++) {
+            strain(u, data, &gradients_[data.nodeGradients + i*data.size], epsilon);
+            value(data.kernel, epsilon, slots[data.dofBegin+i]);
+          }
+        }
+
+        result.resize(size_);
+        #pragma omp parallel for
+        for(long i=0; i<long(size_); i++) {
+          Result sum(0.0);
+          for(auto k=nodeBegin_[i]; k<nodeBegin_[i+1]; k++)
+            sum += slots[nodeSlots_[k]];
+          const auto count = nodeBegin_[i+1]-nodeBegin_[i];
+          if(count > 0)
+            sum /= double(count);
+          result[i] = sum;
+        }
+      }
+
+      template<class VectorType, class Value>
+      void quadrature(const VectorType& u, const Value& value, std::vector<Tensor>& result) const
+      {
+        result.resize(elements_.empty() ? 0 : elements_.back().quadBegin + elements_.back().quadPoints);
+        #pragma omp parallel for
+        for(long e=0; e<long(elements_.size()); e++) {
+          const auto& data = elements_[e];
+          Tensor epsilon;
+          for( std::size_t q=0; q<data.quadPoints; q++) {
+            strain(u, data, &gradients_[data.quadGradients + q*data.size], epsilon);
+            value(data.kernel, epsilon, result[data.quadBegin+q]);
+          }
+        }
+      }
+
+      static void copyStrain(int, const Tensor& strain, Tensor& result) { result = strain; }
+
+      void computeStress(int kernel, const Tensor& strain, Tensor& result) const
+      {
+        kernels_[kernel].stress(strain, result);
+      }
+
+      // sigma_zz, zero in 3D (not part of the tensor there)
+      void computeStressZZ(int kernel, const Tensor& strain, double& result) const
+      {
+        PlaneStress value;
+        computePlaneStress(kernel, strain, value);
+        result = value.zz;
+      }
+
+      void computePlaneStress(int kernel, const Tensor& strain, PlaneStress& result) const
+      {
+        kernels_[kernel].stress(strain, result.stress);
+        result.zz = dim == 2 ? outOfPlane_[kernel]*(result.stress(0,0) + result.stress(1,1)) : 0.0;
+      }
+
+      auto stressValue() const
+      {
+        return [this](int kernel, const Tensor& strain, Tensor& result) { computeStress(kernel, strain, result); };
+      }
+
+    public:
+
+      // one material with the nu and plane assumption of its kernel,
+      // quadOrder < 0: twice the order of the local basis
+      StressRecovery(const Basis& basis, const Kernel& kernel, double nu,
+                     PlaneAssumption assumption = PlaneAssumption::strain, int quadOrder = -1)
+      {
+        const double factor = outOfPlane(assumption, nu);
+        setup(basis, [&](const auto&) { return std::make_pair(&kernel, factor); }, quadOrder);
+      }
+
+      // the materials of the physical groups, nu and the plane assumption are
+      // taken from the table
+      template<class GV>
+      StressRecovery(const Basis& basis, const MaterialTable<GV>& materials, int quadOrder = -1)
+      {
+        setup(basis, [&](const auto& element) {
+          return std::make_pair(&materials.tensor(element),
+                                outOfPlane(materials.assumption(), materials.material(element).nu));
+        }, quadOrder);
+      }
+
+      // elements times quadrature points, in the element order of the grid view
+      template<class VectorType>
+      void quadratureStrain(const VectorType& u, std::vector<Tensor>& strain) const
+      { quadrature(u, copyStrain, strain); }
+
+      template<class VectorType>
+      void quadratureStress(const VectorType& u, std::vector<Tensor>& stress) const
+      { quadrature(u, stressValue(), stress); }
+
+      template<class VectorType>
+      void nodalStrain(const VectorType& u, std::vector<Tensor>& strain) const
+      { nodal(u, copyStrain, strain); }
+
+      template<class VectorType>
+      void nodalStress(const VectorType& u, std::vector<Tensor>& stress) const
+      { nodal(u, stressValue(), stress); }
+
+      // averaged out-of-plane stress sigma_zz, zero for plane stress and in 3D
+      template<class VectorType>
+      void nodalStressZZ(const VectorType& u, std::vector<double>& stress) const
+      {
+        nodal(u, [this](int kernel, const Tensor& strain, double& result) {
+          computeStressZZ(kernel, strain, result);
+        }, stress);
+      }
+
+      // e.g. a BlockVector<FieldVector<double, 1>> for the scalar Lagrange basis,
+      // stress and sigma_zz come from one nodal pass
+      template<class VectorType, class ScalarVector>
+      void nodalVonMises(const VectorType& u, ScalarVector& vonMisesStress) const
+      {
+        std::vector<PlaneStress> stress;
+        nodal(u, [this](int kernel, const Tensor& strain, PlaneStress& result) {
+          computePlaneStress(kernel, strain, result);
+        }, stress);
+        vonMisesStress.resize(size_);
+        for(std::size_t i=0; i<size_; i++)
+          vonMisesStress[i] = vonMises(stress[i].stress, stress[i].zz);
+      }
+  };
+}
+
+#endif
@@ -0,0 +1,231 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef TRACTION_ASSEMBLER_HH
+#define TRACTION_ASSEMBLER_HH
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/geometry/quadraturerules.hh>
+#include <dune/geometry/referenceelements.hh>
+#include <dune/geometry/typeindex.hh>
+#include <dune/grid/common/partitionset.hh>
+
+namespace Dune::Elastodynamics {
+
+  // Surface loads on the faces of one boundary id. The setup pass stores the
+  // quadrature points of all faces (position, unit outer normal, weight times
+  // integration element) and tabulates the shape functions once per element
+  // type and face, an assembly is then a loop over these tables without any
+  // geometry or basis evaluation. The result is added to the load vector, dofs
+  // shared by several faces accumulate. Only interior elements are visited, in
+  // parallel the load is additive.
+  //
+  // For loads f(x,t) = s(t) f0(x), e.g. a pressure history, the reference load
+  // f0 is assembled once and addScaled() is a scaled axpy on the face dofs.
+  template<class Basis>
+  class TractionAssembler {
+
+    public:
+
+      using GridView = typename Basis::GridView;
+      static const int dim = GridView::dimension;
+      static const int dimworld = GridView::dimensionworld;
+      using Range = FieldVector<double, dimworld>;
+
+    private:
+
+      // shape functions of the local basis that do not vanish on the face
+      struct Table {
+        std::vector<int> functions;
+        std::vector<std::vector<double>> values; // [quadrature point][function]
+      };
+
+      struct Face {
+        const Table* table;
+        std::vector<std::size_t> dofs; // compact indices, same order as table->functions
+        std::size_t begin, end;        // quadrature points
+      };
+
+      std::map<std::pair<std::size_t, int>, Table> tables_;
+      std::vector<Face> faces_;
+      std::vector<std::size_t> dofs_;
+      std::vector<Range> positions_, normals_, reference_;
+      std::vector<double> weights_;
+      mutable std::vector<Range> work_;
+
+    public:
+
+      // quadOrder < 0: twice the order of the local basis
+      TractionAssembler(const Basis& basis, const std::vector<int>& boundaryIndex,
+                        int id, int quadOrder = -1)
+      {
+        auto gridView = basis.gridView();
+        auto localView = basis.localView();
+        std::vector<FieldVector<double, 1>> values;
+        std::vector<std::size_t> globalDofs;
+
+        for( const auto& element : elements(gridView, Dune::Partitions::interior)) {
+
+          if(!element.hasBoundaryIntersections())
+            continue;
+
+          localView.bind(element);
+          const auto& node = localView.tree().child(0);
+          const auto& localFE = node.finiteElement();
+          const int order = quadOrder < 0 ? 2*localFE.localBasis().order() : quadOrder;
+          auto ref = referenceElement<double, dim>(element.type());
+
+          for( const auto& isect : intersections(gridView, element)) {
+            if(!isect.boundary() or boundaryIndex[isect.boundarySegmentIndex()] != id)
+              continue;
+
+            const int faceIndex = isect.indexInInside();
+            const auto& quadRule = QuadratureRules<double, dim-1>::rule(isect.type(), order);
+
+            auto key = std::make_pair(LocalGeometryTypeIndex::index(element.type()), faceIndex);
+            auto it = tables_.find(key);
+            if(it == tables_.end()) {
+              Table table;
+              for( std::size_t i=0; i<localFE.size(); i++) {
+                const auto& localKey = localFE.localCoefficients().localKey(i);
+                if(localKey.codim() > 0 and ref.subEntities(faceIndex, 1, localKey.codim()).contains(localKey.subEntity()))
+                  table.functions.push_back(i);
+              }
+              for(const auto& quadPoint : quadRule) {
+                localFE.localBasis().evaluateFunction(isect.geometryInInside().global(quadPoint.position()), values);
+                std::vector<double> row;
+                for(auto i : table.functions)
+                  row.push_back(values[i][0]);
+                table.values.push_back(row);
+              }
+              it = tables_.emplace(key, table).first;
+            }
+
+            Face face;
+            face.table = &it->second;
+            face.begin = weights_.size();
+            const auto geometry = isect.geometry();
+            for(const auto& quadPoint : quadRule) {
+              positions_.push_back(geometry.global(quadPoint.position()));
+              normals_.push_back(isect.unitOuterNormal(quadPoint.position()));
+              weights_.push_back(quadPoint.weight()*geometry.integrationElement(quadPoint.position()));
+            }
+            face.end = weights_.size();
+            for(auto i : face.table->functions) {
+              const auto index = localView.index(node.localIndex(i))[0];
+              face.dofs.push_back(index);
+              globalDofs.push_back(index);
+            }
+            faces_.push_back(face);
+          }
+        }
+
+        // compact numbering of the face dofs
+        dofs_ = globalDofs;
+        std::sort(dofs_.begin(), dofs_.end());
+        dofs_.erase(std::unique(dofs_.begin(), dofs_.end()), dofs_.end());
+        for(auto& face : faces_)
+          for(auto& index : face.dofs)
+            index = std::lower_bound(dofs_.begin(), dofs_.end(), index) - dofs_.begin();
+
+        work_.resize(dofs_.size());
+      }
+
+      // sorted block indices of the loaded dofs
+      const std::vector<std::size_t>& dofs() const { return dofs_; }
+
+      // all quadrature points of the faces, the order of assemble(b, tractions)
+      const std::vector<Range>& positions() const { return positions_; }
+      const std::vector<Range>& normals() const { return normals_; }
+
+      // rank-local measure of the faces
+      double area() const
+      {
+        double area = 0.0;
+        for(auto weight : weights_)
+          area += weight;
+        return area;
+      }
+
+      // b += int t phi with one traction vector per quadrature point
+      template<class VectorType>
+      void assemble(VectorType& b, const std::vector<Range>& tractions) const
+      {
+        integrate([&](std::size_t q) { return tractions[q]; }, work_);
+        for(std::size_t k=0; k<dofs_.size(); k++)
+          b[dofs_[k]] += work_[k];
+      }
+
+      // traction field t(x, n)
+      template<class VectorType, class Traction>
+      void assembleTraction(VectorType& b, const Traction& traction) const
+      {
+        integrate([&](std::size_t q) { return Range(traction(positions_[q], normals_[q])); }, work_);
+        for(std::size_t k=0; k<dofs_.size(); k++)
+          b[dofs_[k]] += work_[k];
+      }
+
+      // pressure p(x) against the outer normal, t = -p n
+      template<class VectorType, class Pressure>
+      void assemblePressure(VectorType& b, const Pressure& pressure) const
+      {
+        assembleTraction(b, [&](const Range& x, const Range& n) {
+          Range t = n;
+          t *= -pressure(x);
+          return t;
+        });
+      }
+
+      // reference loads f0 for addScaled()
+      template<class Traction>
+      void setReferenceTraction(const Traction& traction)
+      {
+        reference_.resize(dofs_.size());
+        integrate([&](std::size_t q) { return Range(traction(positions_[q], normals_[q])); }, reference_);
+      }
+
+      template<class Pressure>
+      void setReferencePressure(const Pressure& pressure)
+      {
+        setReferenceTraction([&](const Range& x, const Range& n) {
+          Range t = n;
+          t *= -pressure(x);
+          return t;
+        });
+      }
+
+      // b += s f0
+      template<class VectorType>
+      void addScaled(VectorType& b, double scale) const
+      {
+        for(std::size_t k=0; k<reference_.size(); k++)
+          b[dofs_[k]].axpy(scale, reference_[k]);
+      }
+
+      // compact load vector over dofs(), the traction is called with the index
+      // of the quadrature point
+      template<class Traction>
+      void integrate(const Traction& traction, std::vector<Range>& result) const
+      {
+        result.resize(dofs_.size());
+        std::fill(result.begin(), result.end(), Range(0.0));
+        for(const auto& face : faces_) {
+          const auto& functions = face.table->functions;
+          for(std::size_t q=face.begin; q<face.end; q++) {
+            Range t = traction(q);
+            t *= weights_[q];
+            const auto& values = face.table->values[q-face.begin];
+            for(std::size_t j=0; j<functions.size(); j++)
+              result[face.dofs[j]].axpy(values[j], t);
+          }
+        }
+      }
+  };
+}
+
+#endif
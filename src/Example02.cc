@@ -66,12 +66,13 @@ int main(int argc, char** argv) {
   blockVector loadVector(basis.size());
   loadVector = 0.0;
   
-  // two nodes at free end, force should sum up to 1N
-  FieldVector<double, dim> force = {0.0, 1.0/33.0};
+  // resultant force of 1N on the free end
+  FieldVector<double, dim> force = {0.0, 1.0};
   
   Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
-  bcAssembler.assembleMatrix(stiffnessMatrix);
-  bcAssembler.assembleVector(loadVector, force);
+  // symmetric elimination keeps the matrix SPD for CG, zero values need no lifting
+  bcAssembler.assembleMatrixSymmetric(stiffnessMatrix);
+  bcAssembler.assembleForce(loadVector, force);
 
   // solve linear system
   blockVector x(basis.size());
@@ -28,8 +28,12 @@
 #include <dune/elastodynamics/assemblers/operatorassembler.hh>
 #include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
 #include <dune/elastodynamics/assemblers/consistentmassassembler.hh>
+#include <dune/elastodynamics/assemblers/materialtable.hh>
+#include <dune/elastodynamics/assemblers/materialassemblers.hh>
 
 #include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
+#include <dune/elastodynamics/utilities/asyncoutputwriter.hh>
+#include <dune/elastodynamics/utilities/stressrecovery.hh>
 
 #include <dune/elastodynamics/timesteppers/coefficients.hh>
 #include <dune/elastodynamics/timesteppers/timestepcontroller.hh>
@@ -64,19 +68,23 @@ int main(int argc, char** argv) {
   using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
   using blockVector  = BlockVector<FieldVector<double, dim>>;
 
+  // materials per physical group of the mesh, nu and the plane assumption also
+  // give the out-of-plane stress of the von Mises output
+  Elastodynamics::MaterialTable<GridView> materials(gridView, factory, materialIndex,
+                                                    {{1, {3.0e7, 0.3, 0.3/386.0}}},
+                                                    Elastodynamics::PlaneAssumption::strain);
+
   // assemble problem
   Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
   
-  double E = 3.0e7, nu = 0.3;
   operatorType stiffnessMatrix;
   operatorAssembler.initialize(stiffnessMatrix);
-  Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu);
+  Elastodynamics::MaterialStiffnessAssembler stiffnessAssembler(materials);
   operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
   
-  double rho = 0.3/386.0;
   operatorType massMatrix;
   operatorAssembler.initialize(massMatrix);
-  Elastodynamics::ConsistentMassAssembler massAssembler(rho);
+  Elastodynamics::MaterialMassAssembler massAssembler(materials);
   operatorAssembler.assemble(massAssembler, massMatrix, false);
 
   blockVector loadVector(basis.size()), displacement(basis.size()), velocity(basis.size()), acceleration(basis.size());
@@ -88,15 +96,33 @@ int main(int argc, char** argv) {
   bcAssembler.assembleMatrix(massMatrix);
   loadMatrixMarket(displacement, "Displacement.mm");
   
-  // generate output writer
+  // generate output writer, the output is bound to its own copy of the
+  // displacement which is written on a background thread
+  blockVector outputDisplacement = displacement;
   using displacementRange = Dune::FieldVector<double, dim>;
   Functions::LagrangeBasis<GridView, p> Pbasis(gridView);
-  auto displacementFunction = Functions::makeDiscreteGlobalBasisFunction<displacementRange> (Pbasis, displacement);
+  auto displacementFunction = Functions::makeDiscreteGlobalBasisFunction<displacementRange> (Pbasis, outputDisplacement);
     
   auto vtkWriter = std::make_shared<SubsamplingVTKWriter<GridView>> (gridView, refinementLevels(2));
   VTKSequenceWriter<GridView> vtkSequenceWriter(vtkWriter, "solid");
   vtkWriter->addVertexData(displacementFunction, VTK::FieldInfo("displacement", VTK::FieldInfo::Type::vector, dim));
-  vtkSequenceWriter.write(0.0);
+
+  // nodal von Mises stress, recovered on the output thread
+  Elastodynamics::StressRecovery recovery(basis, materials);
+  BlockVector<FieldVector<double, 1>> vonMisesStress(basis.size());
+  auto vonMisesFunction = Functions::makeDiscreteGlobalBasisFunction<double> (Pbasis, vonMisesStress);
+  vtkWriter->addVertexData(vonMisesFunction, VTK::FieldInfo("vonMises", VTK::FieldInfo::Type::scalar, 1));
+  auto write = [&](double t) {
+    recovery.nodalVonMises(outputDisplacement, vonMisesStress);
+    vtkSequenceWriter.write(t);
+  };
+  write(0.0);
+
+  // every frame of the sequence is written, the time loop only waits if the
+  // queue of snapshots is full
+  Elastodynamics::AsyncOutputWriter<blockVector> outputWriter(outputDisplacement, write,
+                                                              Elastodynamics::OutputOverflow::block);
+  outputWriter.everyNSteps(1);
     
   // setup looping
   double t = 0.0;
@@ -114,12 +140,14 @@ int main(int argc, char** argv) {
     std::cout << "iter " << iteration_count << std::endl; 
     
     newmark.step(displacement, velocity, acceleration, loadVector);
-    vtkSequenceWriter.write(t);
+    outputWriter.write(displacement, t);
 
     t += dt;
     iteration_count += 1;
 
   }
+  outputWriter.finish();
+  std::cout << "dropped output frames: " << outputWriter.dropped() << std::endl;
 
   return 1;
 } 
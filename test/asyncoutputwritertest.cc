@@ -0,0 +1,137 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/istl/bvector.hh>
+
+#include <dune/elastodynamics/utilities/asyncoutputwriter.hh>
+
+// the snapshots have to reach the callback in order, the block policy writes
+// every frame, the drop policy keeps the newest ones and never waits, write()
+// after finish() and exceptions of the callback are reported
+
+using namespace Dune;
+using Vector = BlockVector<FieldVector<double, 1>>;
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  const int frames = 50;
+
+  // block policy with a slow disk, every frame in order
+  {
+    Vector target(10);
+    target = 0.0;
+    std::vector<double> values, times;
+    auto callback = [&](double t) {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+      values.push_back(target[0]);
+      times.push_back(t);
+    };
+
+    Elastodynamics::AsyncOutputWriter<Vector> writer(target, callback, Elastodynamics::OutputOverflow::block, 2);
+    Vector solution(10);
+    for(int n=0; n<frames; n++) {
+      solution = n;
+      writer.write(solution, 0.1*n);
+    }
+    writer.finish();
+
+    bool ordered = values.size() == frames and writer.dropped() == 0;
+    for(std::size_t n=0; ordered and n<values.size(); n++)
+      ordered = values[n] == n and times[n] == 0.1*n;
+    std::cout << "block policy: " << values.size() << " frames in order: " << ordered << std::endl;
+    passed = passed and ordered;
+  }
+
+  // drop policy, the disk is stuck until all frames are handed over: the first
+  // frame is being written, the queue keeps the newest ones
+  {
+    const std::size_t capacity = 3;
+    Vector target(10);
+    target = 0.0;
+    std::vector<double> values;
+    std::atomic<bool> entered(false), release(false);
+    auto callback = [&](double t) {
+      entered = true;
+      while(!release)
+        std::this_thread::yield();
+      values.push_back(target[0]);
+    };
+
+    Elastodynamics::AsyncOutputWriter<Vector> writer(target, callback, Elastodynamics::OutputOverflow::drop, capacity);
+    Vector solution(10);
+    solution = 0.0;
+    writer.write(solution, 0.0);
+    while(!entered)
+      std::this_thread::yield();
+    for(int n=1; n<frames; n++) {
+      solution = n;
+      writer.write(solution, 0.1*n);
+    }
+    release = true;
+    writer.finish();
+
+    bool kept = values.size() == capacity+1 and writer.dropped() == frames-1-capacity and values[0] == 0;
+    for(std::size_t n=1; kept and n<values.size(); n++)
+      kept = values[n] == frames-1-capacity+n;
+    std::cout << "drop policy: " << writer.dropped() << " dropped, newest kept in order: " << kept << std::endl;
+    passed = passed and kept;
+  }
+
+  // write() after finish() throws instead of waiting forever
+  {
+    Vector target(10);
+    Elastodynamics::AsyncOutputWriter<Vector> writer(target, [](double t) {});
+    writer.finish();
+
+    bool thrown = false;
+    try {
+      writer.write(target, 0.0);
+    }
+    catch(const Dune::InvalidStateException&) {
+      thrown = true;
+    }
+    passed = passed and thrown;
+  }
+
+  // an exception of the callback stops the output and is rethrown by finish()
+  {
+    Vector target(10);
+    target = 0.0;
+    int calls = 0;
+    auto callback = [&](double t) {
+      if(++calls == 3)
+        throw std::runtime_error("disk full");
+    };
+
+    Elastodynamics::AsyncOutputWriter<Vector> writer(target, callback, Elastodynamics::OutputOverflow::block, 1);
+    for(int n=0; n<frames; n++)
+      writer.write(target, 0.1*n);
+
+    bool rethrown = false;
+    try {
+      writer.finish();
+    }
+    catch(const std::runtime_error&) {
+      rethrown = true;
+    }
+    std::cout << "callback exception rethrown: " << rethrown << std::endl;
+    passed = passed and rethrown and calls == 3;
+  }
+
+  return passed ? 0 : 1;
+
+}
@@ -0,0 +1,177 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <cmath>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/scalarproducts.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/umfpack.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+
+#include <dune/elastodynamics/assemblers/operatorassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+
+#include <dune/elastodynamics/preconditioners/chebyshev.hh>
+
+#include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
+
+// the Lanczos bounds have to lie inside the spectrum of D^-1 K of the beam, the
+// largest one close to lambda_max (power iteration), the smallest one above
+// lambda_min (inverse iteration); CG with the Chebyshev preconditioner has to
+// reproduce the direct solve in fewer iterations than with block Jacobi
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // the Sturm count of diag(1, 2, 3) with zero coupling
+  {
+    std::vector<double> diagonal = {1.0, 2.0, 3.0}, offDiagonal = {0.0, 0.0};
+    passed = passed and sturmCount(diagonal, offDiagonal, 0.5) == 0;
+    passed = passed and sturmCount(diagonal, offDiagonal, 2.5) == 2;
+    passed = passed and sturmCount(diagonal, offDiagonal, 3.5) == 3;
+  }
+
+  // generate Grid
+  using Grid = UGGrid<dim>;
+
+  auto mesh = "beam.msh";
+  std::vector<int> materialIndex, boundaryIndex;
+  GridFactory<Grid> factory;
+  GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+  std::shared_ptr<Grid> grid(factory.createGrid());
+  auto gridView = grid->leafGridView();
+
+  // generate Basis
+  using namespace Functions::BasisBuilder;
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  // define operators needed
+  using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
+  using blockVector  = BlockVector<FieldVector<double, dim>>;
+
+  // assemble problem
+  Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+
+  double E = 1000000, nu = 0.3;
+  operatorType stiffnessMatrix;
+  operatorAssembler.initialize(stiffnessMatrix);
+  Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu);
+  operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+  FieldVector<double, dim> force = {0.0, 0.5};
+  blockVector loadVector(basis.size());
+  loadVector = 0.0;
+  Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
+  bcAssembler.assembleMatrix(stiffnessMatrix);
+  bcAssembler.assembleVector(loadVector, force);
+
+  const auto Dinv = Elastodynamics::invertedDiagonal(stiffnessMatrix);
+  SeqScalarProduct<blockVector> scalarProduct;
+  const int lanczosSteps = 30;
+  const auto bounds = lanczosBounds<blockVector>(stiffnessMatrix, Dinv, scalarProduct, lanczosSteps);
+
+  // Rayleigh quotient x^T K x / x^T D x of the pencil (K, D)
+  auto rayleigh = [&](const blockVector& x) {
+    blockVector Kx(x.size()), Dx(x.size());
+    stiffnessMatrix.mv(x, Kx);
+    for(std::size_t i=0; i<x.size(); i++)
+      stiffnessMatrix[i][i].mv(x[i], Dx[i]);
+    return x.dot(Kx)/x.dot(Dx);
+  };
+
+  blockVector start(basis.size());
+  for(std::size_t i=0; i<start.size(); i++)
+    for(int k=0; k<dim; k++)
+      start[i][k] = 1.0 + 0.01*((11*i+5*k) % 17);
+
+  // lambda_max by power iteration on D^-1 K
+  double lambdaMax;
+  {
+    blockVector x = start, y(basis.size()), Kx(basis.size());
+    for(int it=0; it<5000; it++) {
+      stiffnessMatrix.mv(x, Kx);
+      for(std::size_t i=0; i<x.size(); i++)
+        Dinv[i].mv(Kx[i], y[i]);
+      x = y;
+      x /= x.two_norm();
+    }
+    lambdaMax = rayleigh(x);
+  }
+
+  // lambda_min by inverse iteration x = K^-1 D x
+  double lambdaMin;
+  {
+    blockVector x = start, Dx(basis.size());
+    UMFPack<operatorType> solver(stiffnessMatrix);
+    InverseOperatorResult statistics;
+    for(int it=0; it<100; it++) {
+      for(std::size_t i=0; i<x.size(); i++)
+        stiffnessMatrix[i][i].mv(x[i], Dx[i]);
+      solver.apply(x, Dx, statistics);
+      x /= x.two_norm();
+    }
+    lambdaMin = rayleigh(x);
+  }
+
+  std::cout << "lanczos bounds [" << bounds.first << ", " << bounds.second << "], spectrum ["
+            << lambdaMin << ", " << lambdaMax << "]" << std::endl;
+  passed = passed and bounds.first >= lambdaMin*(1.0-1e-8);
+  passed = passed and bounds.first <= bounds.second;
+  passed = passed and std::abs(bounds.second-lambdaMax) <= 0.05*lambdaMax;
+
+  // CG with the Chebyshev preconditioner against block Jacobi
+  {
+    blockVector reference(basis.size()), b(loadVector);
+    InverseOperatorResult statistics;
+    UMFPack<operatorType> direct(stiffnessMatrix);
+    direct.apply(reference, b, statistics);
+
+    MatrixAdapter<operatorType, blockVector, blockVector> op(stiffnessMatrix);
+
+    ChebyshevPreconditioner<operatorType, blockVector> chebyshev(stiffnessMatrix, Dinv, scalarProduct, 8);
+    CGSolver<blockVector> chebyshevSolver(op, chebyshev, 1e-10, 10000, 0);
+    blockVector x(basis.size());
+    x = 0.0, b = loadVector;
+    InverseOperatorResult chebyshevStatistics;
+    chebyshevSolver.apply(x, b, chebyshevStatistics);
+    x -= reference;
+    const double error = x.infinity_norm()/reference.infinity_norm();
+
+    SeqJac<operatorType, blockVector, blockVector> jacobi(stiffnessMatrix, 1, 1.0);
+    CGSolver<blockVector> jacobiSolver(op, jacobi, 1e-10, 10000, 0);
+    x = 0.0, b = loadVector;
+    InverseOperatorResult jacobiStatistics;
+    jacobiSolver.apply(x, b, jacobiStatistics);
+
+    std::cout << "cg iterations: chebyshev " << chebyshevStatistics.iterations << ", block jacobi "
+              << jacobiStatistics.iterations << ", relative error " << error << std::endl;
+    passed = passed and chebyshev.lowerBound() > 0.0 and chebyshev.upperBound() >= bounds.second;
+    passed = passed and chebyshevStatistics.converged and jacobiStatistics.converged;
+    passed = passed and chebyshevStatistics.iterations < jacobiStatistics.iterations;
+    passed = passed and error < 1e-6;
+  }
+
+  return passed ? 0 : 1;
+
+}
@@ -0,0 +1,224 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <cstring>
+#include <filesystem>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bdmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+
+#include <dune/elastodynamics/assemblers/operatorassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+#include <dune/elastodynamics/assemblers/consistentmassassembler.hh>
+#include <dune/elastodynamics/assemblers/hrzlumpedmassassembler.hh>
+
+#include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
+#include <dune/elastodynamics/utilities/checkpoint.hh>
+
+#include <dune/elastodynamics/timesteppers/embeddedrungekuttanystroem.hh>
+#include <dune/elastodynamics/timesteppers/newmark.hh>
+
+// a run of N steps, a checkpoint, a restore into fresh objects and M more
+// steps has to be bit-identical to an uninterrupted run of N+M steps
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+template <class VectorType>
+bool identical(const VectorType& a, const VectorType& b) {
+  return a.size() == b.size()
+    and std::memcmp(&a[0][0], &b[0][0], a.size()*VectorType::block_type::dimension*sizeof(double)) == 0;
+}
+
+bool identical(double a, double b) {
+  return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // generate Grid
+  using Grid = UGGrid<dim>;
+
+  auto mesh = "beam.msh";
+  std::vector<int> materialIndex, boundaryIndex;
+  GridFactory<Grid> factory;
+  GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+  std::shared_ptr<Grid> grid(factory.createGrid());
+  auto gridView = grid->leafGridView();
+
+  // generate Basis
+  using namespace Functions::BasisBuilder;
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  // define operators needed
+  using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
+  using diagonalType = BDMatrix<FieldMatrix<double, dim, dim>>;
+  using blockVector  = BlockVector<FieldVector<double, dim>>;
+
+  // assemble problem
+  Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+
+  double E = 1000000, nu = 0.3, rho = 1.0;
+  operatorType stiffnessMatrix;
+  operatorAssembler.initialize(stiffnessMatrix);
+  Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu);
+  operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+  operatorType massMatrix;
+  operatorAssembler.initialize(massMatrix);
+  Elastodynamics::ConsistentMassAssembler massAssembler(rho);
+  operatorAssembler.assemble(massAssembler, massMatrix, false);
+
+  diagonalType lumpedMassMatrix(basis.size());
+  Elastodynamics::HRZLumpedMassAssembler lumpedMassAssembler(rho);
+  operatorAssembler.assemble(lumpedMassAssembler, lumpedMassMatrix, true);
+
+  Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
+  bcAssembler.assembleMatrix(stiffnessMatrix);
+  bcAssembler.assembleMatrix(massMatrix);
+  bcAssembler.assembleMatrix(lumpedMassMatrix);
+  lumpedMassMatrix.invert();
+
+  blockVector loadVector(basis.size());
+  loadVector = 0.0;
+  for(auto i : bcAssembler.boundaryDofs().vertexDofs(2))
+    loadVector[i] = {0.0, 0.5};
+
+  const int N = 20, M = 15;
+
+  // Newmark, the state is the solution and the fixed step controller
+  {
+    double dt = 0.001;
+    NewmarkCoefficients coefficients = ConstantAcceleration();
+
+    blockVector u(basis.size()), v(basis.size()), a(basis.size());
+    u = 0.0, v = 0.0, a = 0.0;
+    FixedStepController fixed(0.0, dt);
+    Newmark<operatorType, blockVector> newmark(massMatrix, stiffnessMatrix, coefficients, fixed);
+    newmark.initialize(a, loadVector);
+    for(int n=0; n<N; n++)
+      newmark.step(u, v, a, loadVector);
+
+    Elastodynamics::CheckpointWriter writer("newmark.chk");
+    writer.write("displacement", u);
+    writer.write("velocity", v);
+    writer.write("acceleration", a);
+    newmark.save(writer);
+    writer.close();
+
+    for(int n=0; n<M; n++)
+      newmark.step(u, v, a, loadVector);
+
+    // fresh objects, the controller starts somewhere else
+    blockVector ru, rv, ra;
+    FixedStepController restoredFixed(1.0, 2.0*dt);
+    Newmark<operatorType, blockVector> restored(massMatrix, stiffnessMatrix, coefficients, restoredFixed);
+
+    Elastodynamics::CheckpointReader reader("newmark.chk");
+    reader.read("displacement", ru);
+    reader.read("velocity", rv);
+    reader.read("acceleration", ra);
+    restored.restore(reader);
+    for(int n=0; n<M; n++)
+      restored.step(ru, rv, ra, loadVector);
+
+    passed = passed and identical(u, ru) and identical(v, rv) and identical(a, ra);
+    std::cout << "newmark restart bit-identical: " << passed << std::endl;
+  }
+
+  // embedded RKN, the adaptive controller changes dt in every step
+  {
+    double tol = 1e-8;
+    using Stepper = EmbeddedRungeKuttaNystroem<operatorType, blockVector, BettisRKN45Tableau>;
+
+    blockVector u(basis.size()), v(basis.size()), a(basis.size());
+    u = 0.0, v = 0.0, a = 0.0;
+    AdaptiveStepController adaptive(0.0, 0.00001, tol);
+    Stepper rkn(lumpedMassMatrix, stiffnessMatrix, &adaptive);
+    rkn.initialize(loadVector);
+    for(int n=0; n<N; n++)
+      rkn.step(u, v, a, loadVector);
+
+    Elastodynamics::CheckpointWriter writer("embeddedrkn.chk");
+    writer.write("displacement", u);
+    writer.write("velocity", v);
+    rkn.save(writer);
+    writer.close();
+
+    for(int n=0; n<M; n++)
+      rkn.step(u, v, a, loadVector);
+
+    blockVector ru, rv, ra(basis.size());
+    ra = 0.0;
+    AdaptiveStepController restoredAdaptive(0.0, 1.0, tol);
+    Stepper restored(lumpedMassMatrix, stiffnessMatrix, &restoredAdaptive);
+    restored.initialize(loadVector);
+
+    Elastodynamics::CheckpointReader reader("embeddedrkn.chk");
+    reader.read("displacement", ru);
+    reader.read("velocity", rv);
+    restored.restore(reader);
+    for(int n=0; n<M; n++)
+      restored.step(ru, rv, ra, loadVector);
+
+    const bool rknPassed = identical(u, ru) and identical(v, rv)
+      and identical(adaptive.time(), restoredAdaptive.time())
+      and identical(adaptive.deltaT(), restoredAdaptive.deltaT());
+    std::cout << "adaptive restart bit-identical: " << rknPassed << std::endl;
+    passed = passed and rknPassed;
+  }
+
+  // a truncated checkpoint throws instead of restoring garbage
+  {
+    blockVector u(basis.size());
+    u = 1.0;
+    Elastodynamics::CheckpointWriter writer("truncated.chk");
+    writer.write("displacement", u);
+    writer.close();
+    std::filesystem::resize_file("truncated.chk", std::filesystem::file_size("truncated.chk") - sizeof(double));
+
+    bool thrown = false;
+    try {
+      Elastodynamics::CheckpointReader reader("truncated.chk");
+      blockVector ru;
+      reader.read("displacement", ru);
+    }
+    catch(const Dune::IOError&) {
+      thrown = true;
+    }
+    std::cout << "truncated checkpoint throws: " << thrown << std::endl;
+    passed = passed and thrown;
+  }
+
+  // writing to a file that cannot be opened throws
+  {
+    bool thrown = false;
+    try {
+      Elastodynamics::CheckpointWriter writer("missing/directory.chk");
+    }
+    catch(const Dune::IOError&) {
+      thrown = true;
+    }
+    passed = passed and thrown;
+  }
+
+  return passed ? 0 : 1;
+
+}
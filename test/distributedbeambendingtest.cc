@@ -0,0 +1,243 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/umfpack.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+#include <dune/functions/functionspacebases/interpolate.hh>
+
+#include <dune/elastodynamics/assemblers/operatorassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+
+#include <dune/elastodynamics/parallel/distributedmatrixadapter.hh>
+#include <dune/elastodynamics/parallel/distributedvalidation.hh>
+#include <dune/elastodynamics/parallel/dofcommunicator.hh>
+
+#include <dune/elastodynamics/preconditioners/chebyshev.hh>
+#include <dune/elastodynamics/preconditioners/distributedblockjacobi.hh>
+#include <dune/elastodynamics/preconditioners/distributedpreconditioner.hh>
+#include <dune/elastodynamics/preconditioners/distributedscalarproduct.hh>
+#include <dune/elastodynamics/preconditioners/hybridpreconditioner.hh>
+#include <dune/elastodynamics/preconditioners/rigidbodyamg.hh>
+
+#include <dune/elastodynamics/solvers/pipelinedcg.hh>
+
+#include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
+
+// static beam bending on a load-balanced UGGrid: the distributed setup has to
+// pass validateDistributedSetup and every solver has to reproduce the
+// sequential solution computed on rank 0 before the load balancing
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // generate Grid, rank 0 reads the mesh
+  using Grid = UGGrid<dim>;
+
+  auto mesh = "beam.msh";
+  std::vector<int> materialIndex, boundaryIndex;
+  GridFactory<Grid> factory;
+  if(mpiHelper.rank() == 0)
+    GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+  std::shared_ptr<Grid> grid(factory.createGrid());
+  const auto& comm = grid->comm();
+
+  // the boundary segment indices are kept by the load balancing
+  int segments = boundaryIndex.size();
+  comm.broadcast(&segments, 1, 0);
+  boundaryIndex.resize(segments);
+  comm.broadcast(boundaryIndex.data(), segments, 0);
+
+  // define operators needed
+  using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
+  using blockVector  = BlockVector<FieldVector<double, dim>>;
+  using Coordinate   = FieldVector<double, dim>;
+
+  double E = 1000000, nu = 0.3;
+  FieldVector<double, dim> force = {0.0, 0.5};
+  Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu);
+
+  using namespace Functions::BasisBuilder;
+
+  // sequential reference, positions and values of all dofs
+  std::vector<double> reference;
+  {
+    auto gridView = grid->leafGridView();
+    auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+    using Basis = decltype(basis);
+
+    if(mpiHelper.rank() == 0) {
+      operatorType stiffnessMatrix;
+      Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+      operatorAssembler.initialize(stiffnessMatrix);
+      operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+      blockVector loadVector(basis.size()), x(basis.size());
+      loadVector = 0.0;
+      Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
+      bcAssembler.assembleMatrix(stiffnessMatrix);
+      bcAssembler.assembleVector(loadVector, force);
+
+      InverseOperatorResult statistics;
+      UMFPack<operatorType> solver(stiffnessMatrix);
+      solver.apply(x, loadVector, statistics);
+
+      BlockVector<Coordinate> coordinates(basis.size());
+      Functions::interpolate(basis, coordinates, [](const Coordinate& x) { return x; });
+      for(std::size_t i=0; i<basis.size(); i++)
+        for(int k=0; k<dim; k++) {
+          reference.push_back(coordinates[i][k]);
+          reference.push_back(x[i][k]);
+        }
+    }
+
+    int size = reference.size();
+    comm.broadcast(&size, 1, 0);
+    reference.resize(size);
+    comm.broadcast(reference.data(), size, 0);
+  }
+
+  grid->loadBalance();
+  auto gridView = grid->leafGridView();
+
+  // generate Basis
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  // assemble the additive matrix
+  operatorType stiffnessMatrix;
+  Elastodynamics::DistributedOperatorAssembler<Basis> operatorAssembler(basis);
+  operatorAssembler.initialize(stiffnessMatrix);
+  operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+  using Communicator = DofCommunicator<Basis, blockVector>;
+  EntityDofMap<Basis> dofMap(basis);
+  Communicator communicator(dofMap);
+
+  // owner-based Dirichlet rows, the nodal force is set on the copies of
+  // interior elements and made consistent
+  blockVector loadVector(basis.size());
+  loadVector = 0.0;
+  Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex, communicator);
+  bcAssembler.assembleMatrix(stiffnessMatrix, communicator);
+  bcAssembler.assembleVector(loadVector, force);
+  communicator.makeConsistent(loadVector);
+
+  DistributedMatrixAdapter<Communicator, operatorType, blockVector> op(communicator, stiffnessMatrix);
+  DistributedScalarProduct<Communicator, blockVector> scalarProduct(communicator);
+  passed = passed and Elastodynamics::validateDistributedSetup(communicator, op, scalarProduct);
+
+  // dofs of interior elements, the ones only touched by ghost elements are
+  // decoupled and not part of the solution
+  std::vector<bool> interior(basis.size(), false);
+  auto localView = basis.localView();
+  for(const auto& element : elements(gridView, Partitions::interior)) {
+    localView.bind(element);
+    for(std::size_t i=0; i<localView.size(); i++)
+      interior[localView.index(i)[0]] = true;
+  }
+
+  // the sequential solution at the positions of the local dofs
+  BlockVector<Coordinate> coordinates(basis.size());
+  Functions::interpolate(basis, coordinates, [](const Coordinate& x) { return x; });
+  blockVector expected(basis.size());
+  expected = 0.0;
+  bool found = true;
+  for(std::size_t i=0; i<basis.size(); i++) {
+    if(!interior[i])
+      continue;
+    bool match = false;
+    for(std::size_t j=0; j<reference.size() and !match; j+=2*dim) {
+      match = true;
+      for(int k=0; k<dim; k++)
+        match = match and std::abs(reference[j+2*k]-coordinates[i][k]) < 1e-8;
+      if(match)
+        for(int k=0; k<dim; k++)
+          expected[i][k] = reference[j+2*k+1];
+    }
+    found = found and match;
+  }
+  passed = passed and comm.min(int(found)) == 1;
+  const double scale = comm.max(expected.infinity_norm());
+
+  const int verbose = mpiHelper.rank() == 0 ? 1 : 0;
+  auto check = [&](const std::string& name, auto& solver) {
+    blockVector x(basis.size()), b(loadVector);
+    x = 0.0;
+    InverseOperatorResult statistics;
+    solver.apply(x, b, statistics);
+    for(std::size_t i=0; i<basis.size(); i++)
+      if(!interior[i])
+        x[i] = 0.0;
+    x -= expected;
+    const double error = comm.max(x.infinity_norm())/scale;
+    if(mpiHelper.rank() == 0)
+      std::cout << name << ": relative error " << error << std::endl;
+    passed = passed and statistics.converged and error < 1e-6;
+  };
+
+  {
+    DistributedBlockJacobi<Communicator, operatorType, blockVector> preconditioner(communicator, stiffnessMatrix);
+    CGSolver<blockVector> solver(op, scalarProduct, preconditioner, 1e-12, 10000, verbose);
+    check("cg + block jacobi", solver);
+  }
+
+  {
+    HybridPreconditioner<Communicator, operatorType, blockVector> preconditioner(communicator, stiffnessMatrix);
+    Elastodynamics::PipelinedCGSolver<blockVector, decltype(scalarProduct)> solver(op, scalarProduct, preconditioner, 1e-12, 10000, verbose);
+    check("pipelined cg + hybrid ssor", solver);
+  }
+
+  // ILU(0) of the symmetric local matrix is an incomplete Cholesky, so CG applies
+  {
+    using Preconditioner = HybridPreconditioner<Communicator, operatorType, blockVector>;
+    Preconditioner preconditioner(communicator, stiffnessMatrix, Preconditioner::LocalSolver::ilu0);
+    CGSolver<blockVector> solver(op, scalarProduct, preconditioner, 1e-12, 10000, verbose);
+    check("cg + hybrid ilu(0)", solver);
+  }
+
+  // Lanczos bounds from the distributed operator, consistent nodal blocks
+  {
+    const auto Dinv = consistentInvertedDiagonal(communicator, stiffnessMatrix);
+    ChebyshevPreconditioner<decltype(op), blockVector> preconditioner(op, Dinv, scalarProduct, 8);
+    passed = passed and preconditioner.lowerBound() > 0.0 and preconditioner.lowerBound() < preconditioner.upperBound();
+    CGSolver<blockVector> solver(op, scalarProduct, preconditioner, 1e-12, 10000, verbose);
+    check("cg + chebyshev", solver);
+  }
+
+  {
+    auto nullspace = rigidBodyModes(basis);
+    DistributedRigidBodyAMG<Communicator, operatorType, blockVector> preconditioner(communicator, stiffnessMatrix, nullspace, 10, 50);
+    CGSolver<blockVector> solver(op, scalarProduct, preconditioner, 1e-12, 1000, verbose);
+    check("cg + distributed amg", solver);
+  }
+
+  {
+    Richardson<blockVector, blockVector> richardson(1.0);
+    DistributedPreconditioner<Communicator, Richardson<blockVector, blockVector>> preconditioner(communicator, richardson);
+    CGSolver<blockVector> solver(op, scalarProduct, preconditioner, 1e-12, 20000, 0);
+    check("cg + distributed richardson", solver);
+  }
+
+  return passed ? 0 : 1;
+
+}
@@ -0,0 +1,243 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/umfpack.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+#include <dune/functions/functionspacebases/interpolate.hh>
+
+#include <dune/elastodynamics/assemblers/operatorassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+
+#include <dune/elastodynamics/parallel/distributedmatrixadapter.hh>
+#include <dune/elastodynamics/parallel/dofcommunicator.hh>
+
+#include <dune/elastodynamics/preconditioners/distributedblockjacobi.hh>
+#include <dune/elastodynamics/preconditioners/distributedscalarproduct.hh>
+
+#include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
+
+// triangulated beam whose partition cuts the clamped face: the triangles with
+// an edge on x = 0 stay on rank 0, the others go to the other ranks, so the
+// triangle touching the clamp only at the vertex (0, 0.1) has no boundary face
+// on its rank. The boundary dofs reduced over the DofCommunicator have to cover
+// every copy of the clamped dofs and the distributed solution has to match the
+// sequential one.
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // generate Grid, 20 x 2 cells split along the diagonal a-d
+  using Grid = UGGrid<dim>;
+  using Coordinate = FieldVector<double, dim>;
+
+  const int nx = 20, ny = 2;
+  const double length = 6.0, height = 0.2;
+  std::vector<int> boundaryIndex;
+  GridFactory<Grid> factory;
+  if(mpiHelper.rank() == 0) {
+    auto vertex = [&](int i, int j) { return unsigned(j*(nx+1)+i); };
+    for(int j=0; j<=ny; j++)
+      for(int i=0; i<=nx; i++)
+        factory.insertVertex({length*i/nx, height*j/ny});
+    for(int j=0; j<ny; j++)
+      for(int i=0; i<nx; i++) {
+        const unsigned a = vertex(i, j), b = vertex(i+1, j), c = vertex(i, j+1), d = vertex(i+1, j+1);
+        factory.insertElement(GeometryTypes::triangle, {a, b, d});
+        factory.insertElement(GeometryTypes::triangle, {a, d, c});
+      }
+    // boundary ids as in beam.msh: 0 bottom, 1 clamp, 2 tip, 3 top
+    for(int i=0; i<nx; i++) {
+      factory.insertBoundarySegment({vertex(i, 0), vertex(i+1, 0)});
+      boundaryIndex.push_back(0);
+      factory.insertBoundarySegment({vertex(i, ny), vertex(i+1, ny)});
+      boundaryIndex.push_back(3);
+    }
+    for(int j=0; j<ny; j++) {
+      factory.insertBoundarySegment({vertex(0, j), vertex(0, j+1)});
+      boundaryIndex.push_back(1);
+      factory.insertBoundarySegment({vertex(nx, j), vertex(nx, j+1)});
+      boundaryIndex.push_back(2);
+    }
+  }
+  std::shared_ptr<Grid> grid(factory.createGrid());
+  const auto& comm = grid->comm();
+
+  int segments = boundaryIndex.size();
+  comm.broadcast(&segments, 1, 0);
+  boundaryIndex.resize(segments);
+  comm.broadcast(boundaryIndex.data(), segments, 0);
+
+  using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
+  using blockVector  = BlockVector<FieldVector<double, dim>>;
+
+  double E = 1000000, nu = 0.3;
+  FieldVector<double, dim> force = {0.0, 0.5};
+  Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu);
+
+  using namespace Functions::BasisBuilder;
+
+  // sequential reference, positions and values of all dofs, and the partition
+  std::vector<double> reference;
+  std::vector<int> targetProcessors;
+  {
+    auto gridView = grid->leafGridView();
+    auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+    using Basis = decltype(basis);
+
+    if(mpiHelper.rank() == 0) {
+      operatorType stiffnessMatrix;
+      Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+      operatorAssembler.initialize(stiffnessMatrix);
+      operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+      blockVector loadVector(basis.size()), x(basis.size());
+      loadVector = 0.0;
+      Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
+      bcAssembler.assembleMatrix(stiffnessMatrix);
+      bcAssembler.assembleVector(loadVector, force);
+
+      InverseOperatorResult statistics;
+      UMFPack<operatorType> solver(stiffnessMatrix);
+      solver.apply(x, loadVector, statistics);
+
+      BlockVector<Coordinate> coordinates(basis.size());
+      Functions::interpolate(basis, coordinates, [](const Coordinate& x) { return x; });
+      for(std::size_t i=0; i<basis.size(); i++)
+        for(int k=0; k<dim; k++) {
+          reference.push_back(coordinates[i][k]);
+          reference.push_back(x[i][k]);
+        }
+
+      const int ranks = mpiHelper.size();
+      targetProcessors.resize(gridView.size(0));
+      for(const auto& element : elements(gridView)) {
+        bool clamped = false;
+        for(const auto& isect : intersections(gridView, element))
+          clamped = clamped or (isect.boundary() and boundaryIndex[isect.boundarySegmentIndex()] == 1);
+        const int strip = std::min(int(element.geometry().center()[0]/length*(ranks-1)), ranks-2);
+        targetProcessors[gridView.indexSet().index(element)] = (clamped or ranks == 1) ? 0 : 1+strip;
+      }
+    }
+
+    int size = reference.size();
+    comm.broadcast(&size, 1, 0);
+    reference.resize(size);
+    comm.broadcast(reference.data(), size, 0);
+  }
+
+  grid->loadBalance(targetProcessors, 0);
+  auto gridView = grid->leafGridView();
+
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  operatorType stiffnessMatrix;
+  Elastodynamics::DistributedOperatorAssembler<Basis> operatorAssembler(basis);
+  operatorAssembler.initialize(stiffnessMatrix);
+  operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+  using Communicator = DofCommunicator<Basis, blockVector>;
+  EntityDofMap<Basis> dofMap(basis);
+  Communicator communicator(dofMap);
+
+  // dofs of interior elements at x = 0
+  std::vector<bool> interior(basis.size(), false);
+  auto localView = basis.localView();
+  for(const auto& element : elements(gridView, Partitions::interior)) {
+    localView.bind(element);
+    for(std::size_t i=0; i<localView.size(); i++)
+      interior[localView.index(i)[0]] = true;
+  }
+  BlockVector<Coordinate> coordinates(basis.size());
+  Functions::interpolate(basis, coordinates, [](const Coordinate& x) { return x; });
+
+  // the interior elements alone miss a clamped dof on some rank, the reduced
+  // sets cover all of them
+  Elastodynamics::BoundaryDofs<Basis> localDofs(basis, boundaryIndex);
+  Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex, communicator);
+  const auto& clamped = bcAssembler.boundaryDofs().dofs(1);
+  int missedLocally = 0, missed = 0;
+  for(std::size_t i=0; i<basis.size(); i++) {
+    if(!interior[i] or coordinates[i][0] > 1e-10)
+      continue;
+    if(!std::binary_search(localDofs.dofs(1).begin(), localDofs.dofs(1).end(), i))
+      missedLocally++;
+    if(!std::binary_search(clamped.begin(), clamped.end(), i))
+      missed++;
+  }
+  missedLocally = comm.sum(missedLocally);
+  missed = comm.sum(missed);
+  if(mpiHelper.rank() == 0)
+    std::cout << "clamped dofs missed: interior elements " << missedLocally
+              << ", reduced " << missed << std::endl;
+  passed = passed and missed == 0;
+  passed = passed and (mpiHelper.size() == 1 or missedLocally > 0);
+
+  blockVector loadVector(basis.size());
+  loadVector = 0.0;
+  bcAssembler.assembleMatrix(stiffnessMatrix, communicator);
+  bcAssembler.assembleVector(loadVector, force);
+  communicator.makeConsistent(loadVector);
+
+  // the sequential solution at the positions of the local dofs
+  blockVector expected(basis.size());
+  expected = 0.0;
+  bool found = true;
+  for(std::size_t i=0; i<basis.size(); i++) {
+    if(!interior[i])
+      continue;
+    bool match = false;
+    for(std::size_t j=0; j<reference.size() and !match; j+=2*dim) {
+      match = true;
+      for(int k=0; k<dim; k++)
+        match = match and std::abs(reference[j+2*k]-coordinates[i][k]) < 1e-8;
+      if(match)
+        for(int k=0; k<dim; k++)
+          expected[i][k] = reference[j+2*k+1];
+    }
+    found = found and match;
+  }
+  passed = passed and comm.min(int(found)) == 1;
+
+  DistributedMatrixAdapter<Communicator, operatorType, blockVector> op(communicator, stiffnessMatrix);
+  DistributedScalarProduct<Communicator, blockVector> scalarProduct(communicator);
+  DistributedBlockJacobi<Communicator, operatorType, blockVector> preconditioner(communicator, stiffnessMatrix);
+  CGSolver<blockVector> solver(op, scalarProduct, preconditioner, 1e-12, 10000, 0);
+
+  blockVector x(basis.size()), b(loadVector);
+  x = 0.0;
+  InverseOperatorResult statistics;
+  solver.apply(x, b, statistics);
+  for(std::size_t i=0; i<basis.size(); i++)
+    if(!interior[i])
+      x[i] = 0.0;
+  x -= expected;
+  const double error = comm.max(x.infinity_norm())/comm.max(expected.infinity_norm());
+  if(mpiHelper.rank() == 0)
+    std::cout << "cut clamp: relative error " << error << std::endl;
+  passed = passed and statistics.converged and error < 1e-6;
+
+  return passed ? 0 : 1;
+
+}
@@ -28,6 +28,8 @@
 
 #include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
 
+#include <dune/elastodynamics/eigensolvers/subspaceiteration.hh>
+
 using namespace Dune;
 const int dim = 2;
 const int p = 2;
@@ -97,6 +99,36 @@ int main(int argc, char** argv) {
     passed = passed and std::abs(5.638-std::sqrt(lambda)) < 1e-2;
   }
 
+  {
+    // same problem, lowest eigenpairs by subspace iteration
+    Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+  
+    double E = 1000000, nu = 0.3;
+    operatorType stiffnessMatrix;
+    operatorAssembler.initialize(stiffnessMatrix);
+    Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu);
+    operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+  
+    double rho = 1.0;
+    diagonalType massMatrix(basis.size());
+    Elastodynamics::HRZLumpedMassAssembler massAssembler(rho);
+    operatorAssembler.assemble(massAssembler, massMatrix, true);
+
+    Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
+    bcAssembler.assembleMatrix(stiffnessMatrix);
+    bcAssembler.assembleMatrix(massMatrix);
+
+    std::vector<double> eigenvalues;
+    std::vector<blockVector> eigenvectors;
+    Elastodynamics::SubspaceIteration<operatorType, blockVector> eigensolver(massMatrix, stiffnessMatrix,
+                                                                             bcAssembler.boundaryDofs().dofs(1), 100, 1e-10, 1);
+    eigensolver.apply(3, eigenvalues, eigenvectors);
+    std::cout << "smallest eigenvalue (subspace iteration): " << std::sqrt(eigenvalues[0]) << std::endl;
+
+    passed = passed and std::abs(5.638-std::sqrt(eigenvalues[0])) < 1e-2;
+    passed = passed and eigenvalues[0] <= eigenvalues[1] and eigenvalues[1] <= eigenvalues[2];
+  }
+
   return passed ? 0 : 1;
 
 }
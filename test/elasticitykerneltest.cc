@@ -0,0 +1,117 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/elastodynamics/assemblers/elasticitykernels.hh>
+#include <dune/elastodynamics/assemblers/hooketensor.hh>
+#include <dune/elastodynamics/assemblers/symmetrictensor.hh>
+
+// the stress kernels have to agree:
+// - SparseHookeTensor of the HookeTensor and orthotropicHookeTensor with
+//   isotropic constants reproduce IsotropicMaterial::stress
+// - the orthotropic C is symmetric, its normal part inverts the compliance and
+//   the shear part is 2 G in tensor components
+
+using namespace Dune;
+
+std::mt19937 generator(1);
+
+template <int dim, class Kernel>
+double stressError(const Kernel& kernel, const Elastodynamics::IsotropicMaterial<dim>& material) {
+  std::uniform_real_distribution<double> distribution(-1e-3, 1e-3);
+  double error = 0.0;
+  for(int n=0; n<10; n++) {
+    SymmetricTensor<dim> strain, stress, expected;
+    for(auto& value : strain)
+      value = distribution(generator);
+    kernel.stress(strain, stress);
+    material.stress(strain, expected);
+    stress -= expected;
+    error = std::max(error, stress.infinity_norm()/expected.infinity_norm());
+  }
+  return error;
+}
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  using namespace Elastodynamics;
+  double E = 1000000, nu = 0.3;
+
+  // 2D, both plane assumptions
+  for(auto assumption : {PlaneAssumption::strain, PlaneAssumption::stress}) {
+    const IsotropicMaterial<2> material(E, nu, assumption);
+    const HookeTensor<2> hooke(E, nu, assumption);
+    const SparseHookeTensor<2> sparse(hooke.C);
+    const double error = std::max(stressError<2>(hooke, material), stressError<2>(sparse, material));
+    std::cout << "2D " << (assumption == PlaneAssumption::strain ? "plane strain" : "plane stress")
+              << " error: " << error << std::endl;
+    passed = passed and error < 1e-12;
+  }
+
+  // 3D, the dense and sparse isotropic tensor and the orthotropic one with
+  // isotropic constants
+  {
+    const IsotropicMaterial<3> material(E, nu);
+    const HookeTensor<3> hooke(E, nu);
+    const SparseHookeTensor<3> sparse(hooke.C);
+    const double G = E/(2.0*(1.0+nu));
+    const SparseHookeTensor<3> orthotropic(orthotropicHookeTensor({E, E, E}, {nu, nu, nu}, {G, G, G}));
+    const double error = std::max({stressError<3>(hooke, material),
+                                   stressError<3>(sparse, material),
+                                   stressError<3>(orthotropic, material)});
+    std::cout << "3D error: " << error << std::endl;
+    passed = passed and error < 1e-12;
+    passed = passed and sparse.nonZeros() == 12 and orthotropic.nonZeros() == 12;
+  }
+
+  // a real orthotropic material
+  {
+    FieldVector<double, 3> Ei = {10e6, 5e6, 2e6}, nui = {0.25, 0.2, 0.3}, Gi = {3e6, 2e6, 1e6};
+    const auto C = orthotropicHookeTensor(Ei, nui, Gi);
+
+    double asymmetry = 0.0;
+    for(int i=0; i<6; i++)
+      for(int j=0; j<6; j++)
+        asymmetry = std::max(asymmetry, std::abs(C[i][j]-C[j][i]));
+
+    FieldMatrix<double, 3, 3> S = {{1.0/Ei[0],       -nui[0]/Ei[0],  -nui[1]/Ei[0]},
+                                   {-nui[0]/Ei[0],   1.0/Ei[1],      -nui[2]/Ei[1]},
+                                   {-nui[1]/Ei[0],   -nui[2]/Ei[1],  1.0/Ei[2]}};
+    double complianceError = 0.0;
+    for(int i=0; i<3; i++)
+      for(int j=0; j<3; j++) {
+        double CS = 0.0;
+        for(int k=0; k<3; k++)
+          CS += C[i][k]*S[k][j];
+        complianceError = std::max(complianceError, std::abs(CS-(i == j ? 1.0 : 0.0)));
+      }
+
+    double coupling = 0.0, shearError = 0.0;
+    for(int i=0; i<3; i++)
+      for(int k=0; k<3; k++) {
+        coupling = std::max(coupling, std::abs(C[i][3+k]));
+        shearError = std::max(shearError, std::abs(C[3+i][3+k]-(i == k ? 2.0*Gi[k] : 0.0)));
+      }
+
+    std::cout << "orthotropic asymmetry: " << asymmetry << ", C S - I: " << complianceError
+              << ", shear error: " << shearError << std::endl;
+    passed = passed and asymmetry <= 1e-12*C.infinity_norm();
+    passed = passed and complianceError < 1e-12;
+    passed = passed and coupling == 0.0 and shearError == 0.0;
+  }
+
+  return passed ? 0 : 1;
+
+}
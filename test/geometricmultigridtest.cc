@@ -0,0 +1,164 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <memory>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/scalarproducts.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/umfpack.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+
+#include <dune/elastodynamics/assemblers/operatorassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+#include <dune/elastodynamics/assemblers/consistentmassassembler.hh>
+
+#include <dune/elastodynamics/preconditioners/geometricmultigrid.hh>
+
+#include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
+
+#include <dune/elastodynamics/timesteppers/newmark.hh>
+
+// the V-cycle on the twice refined beam has to beat ILU(0) in CG iterations for
+// the static problem and to reproduce the UMFPack solves of Newmark's efficient
+// mass when it is passed by setSolver
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // generate Grid, the hierarchy comes from uniform refinement
+  using Grid = UGGrid<dim>;
+
+  auto mesh = "beam.msh";
+  std::vector<int> materialIndex, boundaryIndex;
+  GridFactory<Grid> factory;
+  GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+  std::shared_ptr<Grid> grid(factory.createGrid());
+  grid->globalRefine(2);
+  auto gridView = grid->leafGridView();
+
+  // generate Basis
+  using namespace Functions::BasisBuilder;
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  // define operators needed
+  using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
+  using blockVector  = BlockVector<FieldVector<double, dim>>;
+  using Multigrid    = GeometricMultigrid<Grid, p, operatorType, blockVector>;
+
+  // assemble problem
+  Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+
+  double E = 1000000, nu = 0.3, rho = 1.0;
+  operatorType stiffnessMatrix;
+  operatorAssembler.initialize(stiffnessMatrix);
+  Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu);
+  operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+  operatorType massMatrix;
+  operatorAssembler.initialize(massMatrix);
+  Elastodynamics::ConsistentMassAssembler massAssembler(rho);
+  operatorAssembler.assemble(massAssembler, massMatrix, false);
+
+  FieldVector<double, dim> force = {0.0, 0.5};
+  blockVector loadVector(basis.size());
+  loadVector = 0.0;
+  Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
+  bcAssembler.assembleMatrix(stiffnessMatrix);
+  bcAssembler.assembleMatrix(massMatrix);
+  bcAssembler.assembleVector(loadVector, force);
+
+  // static solve, CG with one V-cycle against CG with ILU(0)
+  {
+    blockVector reference(basis.size()), b(loadVector);
+    InverseOperatorResult statistics;
+    UMFPack<operatorType> direct(stiffnessMatrix);
+    direct.apply(reference, b, statistics);
+
+    MatrixAdapter<operatorType, blockVector, blockVector> op(stiffnessMatrix);
+
+    Multigrid multigrid(*grid, stiffnessMatrix);
+    CGSolver<blockVector> multigridSolver(op, multigrid, 1e-10, 1000, 0);
+    blockVector x(basis.size());
+    x = 0.0, b = loadVector;
+    InverseOperatorResult multigridStatistics;
+    multigridSolver.apply(x, b, multigridStatistics);
+    x -= reference;
+    const double error = x.infinity_norm()/reference.infinity_norm();
+
+    SeqILU<operatorType, blockVector, blockVector> ilu(stiffnessMatrix, 1.0);
+    CGSolver<blockVector> iluSolver(op, ilu, 1e-10, 10000, 0);
+    x = 0.0, b = loadVector;
+    InverseOperatorResult iluStatistics;
+    iluSolver.apply(x, b, iluStatistics);
+
+    std::cout << "levels: " << multigrid.levels() << ", cg iterations: multigrid "
+              << multigridStatistics.iterations << ", ilu(0) " << iluStatistics.iterations
+              << ", relative error " << error << std::endl;
+    passed = passed and multigrid.levels() == 3;
+    passed = passed and multigridStatistics.converged and iluStatistics.converged;
+    passed = passed and multigridStatistics.iterations < iluStatistics.iterations;
+    passed = passed and error < 1e-6;
+  }
+
+  // Newmark with the multigrid solver for M + beta dt^2 K
+  {
+    const double dt = 0.001;
+    const int steps = 20;
+    NewmarkCoefficients coefficients = ConstantAcceleration();
+
+    blockVector u(basis.size()), v(basis.size()), a(basis.size());
+    u = 0.0, v = 0.0, a = 0.0;
+    {
+      FixedStepController fixed(0.0, dt);
+      Newmark<operatorType, blockVector> newmark(massMatrix, stiffnessMatrix, coefficients, fixed);
+      newmark.initialize(a, loadVector);
+      for(int n=0; n<steps; n++)
+        newmark.step(u, v, a, loadVector);
+    }
+
+    blockVector mu(basis.size()), mv(basis.size()), ma(basis.size());
+    mu = 0.0, mv = 0.0, ma = 0.0;
+    {
+      FixedStepController fixed(0.0, dt);
+      Newmark<operatorType, blockVector> newmark(massMatrix, stiffnessMatrix, coefficients, fixed);
+      newmark.setSolver([&](const operatorType& A) -> std::shared_ptr<InverseOperator<blockVector, blockVector>> {
+        auto op = std::make_shared<MatrixAdapter<operatorType, blockVector, blockVector>>(A);
+        auto sp = std::make_shared<SeqScalarProduct<blockVector>>();
+        auto mg = std::make_shared<Multigrid>(*grid, A);
+        return std::make_shared<CGSolver<blockVector>>(op, sp, mg, 1e-12, 100, 0);
+      });
+      newmark.initialize(ma, loadVector);
+      for(int n=0; n<steps; n++)
+        newmark.step(mu, mv, ma, loadVector);
+    }
+
+    mu -= u;
+    const double error = mu.infinity_norm()/u.infinity_norm();
+    std::cout << "newmark with multigrid: relative error " << error << std::endl;
+    passed = passed and u.infinity_norm() > 0.0 and error < 1e-6;
+  }
+
+  return passed ? 0 : 1;
+
+}
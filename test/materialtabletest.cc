@@ -0,0 +1,176 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <map>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bdmatrix.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+
+#include <dune/elastodynamics/assemblers/operatorassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+#include <dune/elastodynamics/assemblers/consistentmassassembler.hh>
+#include <dune/elastodynamics/assemblers/hrzlumpedmassassembler.hh>
+#include <dune/elastodynamics/assemblers/materialtable.hh>
+#include <dune/elastodynamics/assemblers/materialassemblers.hh>
+
+// the beam with two physical groups (1 for x < 3, 2 for x > 3):
+// - the material assemblers equal the sum of the single material assemblers
+//   restricted to the elements of each group
+// - a group without a material throws a RangeError
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+// local matrices of elements outside the group are zero
+template<class LocalAssembler, class GridView>
+struct GroupAssembler {
+
+  typedef typename LocalAssembler::LocalMatrix LocalMatrix;
+
+  LocalAssembler& assembler;
+  const GridView& gridView;
+  const std::vector<int>& elementGroup;
+  int group;
+
+  template <class LocalView>
+  void assemble(LocalMatrix& localMatrix, LocalView& localView) {
+    assembler.assemble(localMatrix, localView);
+    if(elementGroup[gridView.indexSet().index(localView.element())] != group)
+      localMatrix = 0.0;
+  }
+};
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // generate Grid
+  using Grid = UGGrid<dim>;
+
+  auto mesh = "beam.msh";
+  std::vector<int> materialIndex, boundaryIndex;
+  GridFactory<Grid> factory;
+  GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+  std::shared_ptr<Grid> grid(factory.createGrid());
+  auto gridView = grid->leafGridView();
+  using GridView = decltype(gridView);
+
+  // retag the half x > 3 of the beam
+  std::vector<int> elementGroup(gridView.size(0));
+  for(const auto& element : elements(gridView)) {
+    const int group = element.geometry().center()[0] < 3.0 ? 1 : 2;
+    materialIndex[factory.insertionIndex(element)] = group;
+    elementGroup[gridView.indexSet().index(element)] = group;
+  }
+
+  // generate Basis
+  using namespace Functions::BasisBuilder;
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
+  using diagonalType = BDMatrix<FieldMatrix<double, dim, dim>>;
+
+  const std::map<int, Elastodynamics::Material> materials = {{1, {1000000, 0.3, 1.0}}, {2, {5000000, 0.25, 3.0}}};
+  Elastodynamics::MaterialTable<GridView> table(gridView, factory, materialIndex, materials);
+  Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+
+  // relative difference of the material matrix and the sum over the groups
+  auto compare = [](const auto& A, const auto& reference) {
+    auto difference = A;
+    difference -= reference;
+    return difference.infinity_norm()/reference.infinity_norm();
+  };
+
+  // stiffness
+  {
+    operatorType stiffnessMatrix;
+    operatorAssembler.initialize(stiffnessMatrix);
+    Elastodynamics::MaterialStiffnessAssembler stiffnessAssembler(table);
+    operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+    operatorType reference;
+    operatorAssembler.initialize(reference);
+    reference = 0.0;
+    for(const auto& [group, material] : materials) {
+      operatorType groupMatrix;
+      operatorAssembler.initialize(groupMatrix);
+      Elastodynamics::StiffnessAssembler assembler(material.E, material.nu);
+      GroupAssembler<decltype(assembler), GridView> groupAssembler{assembler, gridView, elementGroup, group};
+      operatorAssembler.assemble(groupAssembler, groupMatrix, false);
+      reference += groupMatrix;
+    }
+
+    const double error = compare(stiffnessMatrix, reference);
+    std::cout << "material stiffness error: " << error << std::endl;
+    passed = passed and error < 1e-12;
+  }
+
+  // consistent and HRZ lumped mass
+  {
+    operatorType massMatrix;
+    operatorAssembler.initialize(massMatrix);
+    Elastodynamics::MaterialMassAssembler<decltype(table)> massAssembler(table);
+    operatorAssembler.assemble(massAssembler, massMatrix, false);
+
+    diagonalType lumpedMatrix(basis.size());
+    Elastodynamics::MaterialMassAssembler<decltype(table), Elastodynamics::HRZLumpedMassAssembler> lumpedAssembler(table);
+    operatorAssembler.assemble(lumpedAssembler, lumpedMatrix, true);
+
+    operatorType reference;
+    operatorAssembler.initialize(reference);
+    reference = 0.0;
+    diagonalType lumpedReference(basis.size());
+    lumpedReference = 0.0;
+    for(const auto& [group, material] : materials) {
+      operatorType groupMatrix;
+      operatorAssembler.initialize(groupMatrix);
+      Elastodynamics::ConsistentMassAssembler assembler(material.rho);
+      GroupAssembler<decltype(assembler), GridView> groupAssembler{assembler, gridView, elementGroup, group};
+      operatorAssembler.assemble(groupAssembler, groupMatrix, false);
+      reference += groupMatrix;
+
+      diagonalType lumpedGroupMatrix(basis.size());
+      Elastodynamics::HRZLumpedMassAssembler lumped(material.rho);
+      GroupAssembler<decltype(lumped), GridView> lumpedGroupAssembler{lumped, gridView, elementGroup, group};
+      operatorAssembler.assemble(lumpedGroupAssembler, lumpedGroupMatrix, true);
+      lumpedReference += lumpedGroupMatrix;
+    }
+
+    const double error = compare(massMatrix, reference);
+    const double lumpedError = compare(lumpedMatrix, lumpedReference);
+    std::cout << "material mass error: consistent " << error << ", hrz " << lumpedError << std::endl;
+    passed = passed and error < 1e-12 and lumpedError < 1e-12;
+  }
+
+  // group 2 has no material
+  {
+    bool thrown = false;
+    try {
+      Elastodynamics::MaterialTable<GridView> incomplete(gridView, factory, materialIndex, {{1, {1000000, 0.3, 1.0}}});
+    }
+    catch(const RangeError&) {
+      thrown = true;
+    }
+    std::cout << "missing group rejected: " << thrown << std::endl;
+    passed = passed and thrown;
+  }
+
+  return passed ? 0 : 1;
+
+}
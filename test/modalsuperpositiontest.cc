@@ -0,0 +1,182 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bdmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+
+#include <dune/elastodynamics/assemblers/operatorassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+#include <dune/elastodynamics/assemblers/hrzlumpedmassassembler.hh>
+
+#include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
+
+#include <dune/elastodynamics/timesteppers/modalsuperposition.hh>
+
+// a load or an initial displacement in the shape of the first mode only excites
+// this mode, the response is the analytic one of a single oscillator:
+// - free vibration u(t) = cos(w t) phi
+// - step load M phi: u(t) = (1 - cos(w t))/w^2 phi
+// a roller at the tip (only the vertical component constrained) has to give
+// the frequency of the propped cantilever, not the identity rows
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // generate Grid
+  using Grid = UGGrid<dim>;
+
+  auto mesh = "beam.msh";
+  std::vector<int> materialIndex, boundaryIndex;
+  GridFactory<Grid> factory;
+  GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+  std::shared_ptr<Grid> grid(factory.createGrid());
+  auto gridView = grid->leafGridView();
+
+  // generate Basis
+  using namespace Functions::BasisBuilder;
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  // define operators needed
+  using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
+  using diagonalType = BDMatrix<FieldMatrix<double, dim, dim>>;
+  using blockVector  = BlockVector<FieldVector<double, dim>>;
+
+  // assemble problem
+  Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+
+  double E = 1000000, nu = 0.3;
+  operatorType stiffnessMatrix;
+  operatorAssembler.initialize(stiffnessMatrix);
+  Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu);
+  operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+  double rho = 1.0;
+  diagonalType massMatrix(basis.size());
+  Elastodynamics::HRZLumpedMassAssembler massAssembler(rho);
+  operatorAssembler.assemble(massAssembler, massMatrix, true);
+
+  Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
+  bcAssembler.assembleMatrix(stiffnessMatrix);
+  bcAssembler.assembleMatrix(massMatrix);
+  const auto& constrained = bcAssembler.boundaryDofs().dofs(1);
+
+  // dt far beyond any explicit stability limit
+  double t = 0.0, dt = 0.01;
+  const int steps = 100;
+
+  blockVector displacement(basis.size()), velocity(basis.size()), acceleration(basis.size());
+  blockVector loadVector(basis.size()), exact(basis.size());
+
+  // free vibration of the first mode
+  {
+    FixedStepController fixed(t, dt);
+    ModalSuperposition<operatorType, blockVector> modal(massMatrix, stiffnessMatrix, constrained, 3, fixed);
+    const auto& phi = modal.modes()[0];
+    const double w = modal.frequencies()[0];
+    std::cout << "first frequency: " << w << std::endl;
+    passed = passed and std::abs(5.638-w) < 1e-2;
+
+    loadVector = 0.0;
+    modal.initialize(loadVector);
+    modal.setInitialValues(phi, loadVector);
+
+    double error = 0.0;
+    for(int n=1; n<=steps; n++) {
+      modal.step(displacement, velocity, acceleration, loadVector);
+      exact = phi;
+      exact *= std::cos(w*n*dt);
+      exact -= displacement;
+      error = std::max(error, exact.infinity_norm());
+    }
+    std::cout << "free vibration error: " << error << std::endl;
+    passed = passed and error < 1e-6*phi.infinity_norm();
+  }
+
+  // step load in the shape of the first mode, starting at rest
+  {
+    FixedStepController fixed(t, dt);
+    ModalSuperposition<operatorType, blockVector> modal(massMatrix, stiffnessMatrix, constrained, 3, fixed);
+    const auto& phi = modal.modes()[0];
+    const double w = modal.frequencies()[0];
+
+    massMatrix.mv(phi, loadVector);
+    modal.initialize(loadVector);
+
+    double error = 0.0;
+    for(int n=1; n<=steps; n++) {
+      modal.step(displacement, velocity, acceleration, loadVector);
+      exact = phi;
+      exact *= (1.0-std::cos(w*n*dt))/(w*w);
+      exact -= displacement;
+      error = std::max(error, exact.infinity_norm());
+    }
+    std::cout << "step load error: " << error << std::endl;
+    passed = passed and error < 1e-6*phi.infinity_norm()/(w*w);
+  }
+
+  // roller at the tip, the vertical rows and columns are eliminated
+  {
+    operatorType rollerStiffness = stiffnessMatrix;
+    diagonalType rollerMass = massMatrix;
+    const auto& tip = bcAssembler.boundaryDofs().dofs(2);
+    std::vector<bool> roller(basis.size(), false);
+    std::vector<std::pair<std::size_t, int>> constrainedComponents;
+    for(auto i : tip) {
+      roller[i] = true;
+      constrainedComponents.emplace_back(i, 1);
+    }
+    auto eliminate = [&](auto& matrix) {
+      for(auto row = matrix.begin(); row != matrix.end(); ++row)
+        for(auto col = row->begin(); col != row->end(); ++col) {
+          if(roller[row.index()])
+            (*col)[1] = 0.0;
+          if(roller[col.index()])
+            for(int k=0; k<dim; k++)
+              (*col)[k][1] = 0.0;
+          if(roller[row.index()] and row.index() == col.index())
+            (*col)[1][1] = 1.0;
+        }
+    };
+    eliminate(rollerStiffness);
+    eliminate(rollerMass);
+
+    // (3.9266/1.8751)^2 times the cantilever frequency by Euler-Bernoulli
+    FixedStepController fixed(t, dt);
+    ModalSuperposition<operatorType, blockVector> modal(rollerMass, rollerStiffness, constrained, 3, fixed,
+                                                        1e-8, constrainedComponents);
+    const double w = modal.frequencies()[0];
+    double tipDisplacement = 0.0;
+    for(auto i : tip)
+      tipDisplacement = std::max(tipDisplacement, std::abs(modal.modes()[0][i][1]));
+    std::cout << "first frequency with roller: " << w << std::endl;
+    passed = passed and std::abs(w/5.638 - 4.385) < 0.03*4.385;
+    passed = passed and tipDisplacement == 0.0;
+  }
+
+  return passed ? 0 : 1;
+
+}
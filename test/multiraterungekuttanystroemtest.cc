@@ -0,0 +1,203 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bdmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+
+#include <dune/elastodynamics/assemblers/operatorassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+#include <dune/elastodynamics/assemblers/hrzlumpedmassassembler.hh>
+
+#include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
+
+#include <dune/elastodynamics/timesteppers/multiraterungekuttanystroem.hh>
+#include <dune/elastodynamics/timesteppers/rungekuttanystroem.hh>
+
+// the multirate method with a single level has to reproduce the single-rate
+// Runge-Kutta-Nyström method, with a stiffened tip it has to follow the
+// single-rate method at the finest step and stay stable over a long run
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+// elements right of x0 are stiffer by factor, their dofs need a smaller step
+struct StiffenedAssembler {
+
+  using LocalMatrix = Elastodynamics::StiffnessAssembler::LocalMatrix;
+
+  Elastodynamics::StiffnessAssembler soft, stiff;
+  double x0;
+
+  template <class LocalView>
+  void assemble(LocalMatrix& localMatrix, LocalView& localView) {
+    if(localView.element().geometry().center()[0] > x0)
+      stiff.assemble(localMatrix, localView);
+    else
+      soft.assemble(localMatrix, localView);
+  }
+
+};
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // stability intervals of the tableaux
+  {
+    RKNCoefficients rkn4 = RKN4();
+    RKNCoefficients rkn5 = RKN5();
+    const double interval4 = stabilityInterval(rkn4);
+    const double interval5 = stabilityInterval(rkn5);
+    std::cout << "stability intervals: " << interval4 << ", " << interval5 << std::endl;
+    passed = passed and std::abs(interval4-2.586) < 1e-2;
+    passed = passed and std::abs(interval5-3.117) < 1e-2;
+  }
+
+  // generate Grid
+  using Grid = UGGrid<dim>;
+
+  auto mesh = "beam.msh";
+  std::vector<int> materialIndex, boundaryIndex;
+  GridFactory<Grid> factory;
+  GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+  std::shared_ptr<Grid> grid(factory.createGrid());
+  auto gridView = grid->leafGridView();
+
+  // generate Basis
+  using namespace Functions::BasisBuilder;
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  // define operators needed
+  using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
+  using diagonalType = BDMatrix<FieldMatrix<double, dim, dim>>;
+  using blockVector  = BlockVector<FieldVector<double, dim>>;
+
+  // assemble problem
+  Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+
+  double E = 1000000, nu = 0.3;
+  operatorType stiffnessMatrix;
+  operatorAssembler.initialize(stiffnessMatrix);
+  Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu);
+  operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+  double rho = 1.0;
+  diagonalType massMatrix(basis.size());
+  Elastodynamics::HRZLumpedMassAssembler massAssembler(rho);
+  operatorAssembler.assemble(massAssembler, massMatrix, true);
+
+  Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
+  bcAssembler.assembleMatrix(stiffnessMatrix);
+  bcAssembler.assembleMatrix(massMatrix);
+  massMatrix.invert();
+
+  blockVector loadVector(basis.size());
+  loadVector = 0.0;
+  for(auto i : bcAssembler.boundaryDofs().vertexDofs(2))
+    loadVector[i] = {0.0, 0.5};
+
+  // same steps with both methods
+  double t = 0.0, dt = 0.00001;
+  const int steps = 50;
+  RKNCoefficients coefficients = RKN4();
+
+  blockVector displacement(basis.size()), velocity(basis.size()), acceleration(basis.size());
+  displacement = 0.0, velocity = 0.0, acceleration = 0.0;
+  {
+    FixedStepController fixed(t, dt);
+    RungeKuttaNystroem<operatorType, blockVector> rkn(massMatrix, stiffnessMatrix, coefficients, fixed);
+    rkn.initialize(loadVector);
+    for(int n=0; n<steps; n++)
+      rkn.step(displacement, velocity, acceleration, loadVector);
+  }
+
+  blockVector multirateDisplacement(basis.size()), multirateVelocity(basis.size());
+  multirateDisplacement = 0.0, multirateVelocity = 0.0;
+  {
+    FixedStepController fixed(t, dt);
+    MultirateRungeKuttaNystroem<operatorType, blockVector> rkn(massMatrix, stiffnessMatrix, coefficients, fixed, 1);
+    rkn.initialize(loadVector);
+    passed = passed and rkn.levels() == 1;
+    for(int n=0; n<steps; n++)
+      rkn.step(multirateDisplacement, multirateVelocity, acceleration, loadVector);
+  }
+
+  multirateDisplacement -= displacement;
+  multirateVelocity -= velocity;
+  std::cout << "difference to single-rate: " << multirateDisplacement.infinity_norm() << ", "
+            << multirateVelocity.infinity_norm() << std::endl;
+  passed = passed and displacement.infinity_norm() > 0.0;
+  passed = passed and multirateDisplacement.infinity_norm() <= 1e-12*displacement.infinity_norm();
+  passed = passed and multirateVelocity.infinity_norm() <= 1e-12*velocity.infinity_norm();
+
+  // locally stiffened tip, the coarse step is too large for its dofs
+  {
+    StiffenedAssembler stiffenedAssembler{Elastodynamics::StiffnessAssembler(E, nu),
+                                          Elastodynamics::StiffnessAssembler(100*E, nu), 4.5};
+    operatorType stiffenedMatrix;
+    operatorAssembler.initialize(stiffenedMatrix);
+    operatorAssembler.assemble(stiffenedAssembler, stiffenedMatrix, false);
+    bcAssembler.assembleMatrix(stiffenedMatrix);
+
+    const double coarseDt = 0.00002;
+    const int coarseSteps = 100;
+
+    blockVector multirateDisplacement(basis.size()), multirateVelocity(basis.size());
+    multirateDisplacement = 0.0, multirateVelocity = 0.0;
+    FixedStepController coarse(t, coarseDt);
+    MultirateRungeKuttaNystroem<operatorType, blockVector> multirate(massMatrix, stiffenedMatrix, coefficients, coarse, 4);
+    const int levels = multirate.levels();
+    multirate.initialize(loadVector);
+    for(int n=0; n<coarseSteps; n++)
+      multirate.step(multirateDisplacement, multirateVelocity, acceleration, loadVector);
+
+    // single-rate reference at the step of the finest level
+    const int substeps = 1 << (levels-1);
+    blockVector displacement(basis.size()), velocity(basis.size());
+    displacement = 0.0, velocity = 0.0;
+    FixedStepController fine(t, coarseDt/substeps);
+    RungeKuttaNystroem<operatorType, blockVector> rkn(massMatrix, stiffenedMatrix, coefficients, fine);
+    rkn.initialize(loadVector);
+    for(int n=0; n<coarseSteps*substeps; n++)
+      rkn.step(displacement, velocity, acceleration, loadVector);
+
+    blockVector difference = multirateDisplacement;
+    difference -= displacement;
+    std::cout << "levels: " << levels << ", difference to fine single-rate: "
+              << difference.infinity_norm() << " of " << displacement.infinity_norm() << std::endl;
+    passed = passed and levels > 1;
+    passed = passed and displacement.infinity_norm() > 0.0;
+    passed = passed and difference.infinity_norm() <= 1e-2*displacement.infinity_norm();
+
+    // long run, a dynamic tip load at most doubles the static deflection
+    double maxDisplacement = 0.0;
+    for(int n=coarseSteps; n<20000; n++) {
+      multirate.step(multirateDisplacement, multirateVelocity, acceleration, loadVector);
+      maxDisplacement = std::max(maxDisplacement, multirateDisplacement.infinity_norm());
+    }
+    std::cout << "maximal displacement of the long run: " << maxDisplacement << std::endl;
+    passed = passed and std::isfinite(maxDisplacement) and maxDisplacement > 0.0;
+    passed = passed and maxDisplacement < 0.25;
+  }
+
+  return passed ? 0 : 1;
+
+}
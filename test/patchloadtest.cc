@@ -0,0 +1,151 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bvector.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+
+#include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
+
+// the loads of the tip face (id 2, x = 6, 0 <= y <= 0.2) of the beam:
+// - the resultant of a total force F is F
+// - the resultant of a pressure p is -p |patch| n with n = (1, 0)
+// a patch on the top next to the clamp (x <= 1.2) shares the corner (0, 0.2)
+// with id 1, assembleForce has to leave its clamped rows zero
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // generate Grid
+  using Grid = UGGrid<dim>;
+
+  auto mesh = "beam.msh";
+  std::vector<int> materialIndex, boundaryIndex;
+  GridFactory<Grid> factory;
+  GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+  std::shared_ptr<Grid> grid(factory.createGrid());
+  auto gridView = grid->leafGridView();
+
+  // generate Basis
+  using namespace Functions::BasisBuilder;
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  using blockVector = BlockVector<FieldVector<double, dim>>;
+  using Range       = FieldVector<double, dim>;
+
+  auto resultant = [](const blockVector& b) {
+    Range sum(0.0);
+    for(const auto& block : b)
+      sum += block;
+    return sum;
+  };
+
+  Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
+
+  // total force
+  {
+    Range force = {0.3, -0.5};
+    blockVector loadVector(basis.size());
+    loadVector = 0.0;
+    bcAssembler.assembleForce(loadVector, force);
+    Range sum = resultant(loadVector);
+    sum -= force;
+    std::cout << "force resultant error: " << sum.infinity_norm() << std::endl;
+    passed = passed and sum.infinity_norm() < 1e-12;
+
+    // rescaling at runtime is an axpy on the same weights
+    bcAssembler.patchLoad().addForce(loadVector, force);
+    sum = resultant(loadVector);
+    sum.axpy(-2.0, force);
+    passed = passed and sum.infinity_norm() < 1e-12;
+  }
+
+  // uniform pressure
+  {
+    const auto& load = bcAssembler.patchLoad();
+    std::cout << "patch area: " << load.area() << std::endl;
+    passed = passed and std::abs(load.area()-0.2) < 1e-12;
+
+    const double pressure = 10.0;
+    blockVector loadVector(basis.size());
+    loadVector = 0.0;
+    load.addPressure(loadVector, pressure);
+    Range sum = resultant(loadVector);
+    sum -= Range({-pressure*0.2, 0.0});
+    std::cout << "pressure resultant error: " << sum.infinity_norm() << std::endl;
+    passed = passed and sum.infinity_norm() < 1e-12;
+  }
+
+  // loaded patch adjacent to the clamp, 20 x 2 cells with ids 0 bottom and
+  // tip, 1 clamp, 2 top for x <= 1.2, 3 rest of the top
+  {
+    const int nx = 20, ny = 2, loaded = 4;
+    std::vector<int> patchIndex;
+    GridFactory<Grid> patchFactory;
+    auto vertex = [&](int i, int j) { return unsigned(j*(nx+1)+i); };
+    for(int j=0; j<=ny; j++)
+      for(int i=0; i<=nx; i++)
+        patchFactory.insertVertex({6.0*i/nx, 0.2*j/ny});
+    for(int j=0; j<ny; j++)
+      for(int i=0; i<nx; i++)
+        patchFactory.insertElement(GeometryTypes::quadrilateral,
+                                   {vertex(i, j), vertex(i+1, j), vertex(i, j+1), vertex(i+1, j+1)});
+    for(int i=0; i<nx; i++) {
+      patchFactory.insertBoundarySegment({vertex(i, 0), vertex(i+1, 0)});
+      patchIndex.push_back(0);
+      patchFactory.insertBoundarySegment({vertex(i, ny), vertex(i+1, ny)});
+      patchIndex.push_back(i < loaded ? 2 : 3);
+    }
+    for(int j=0; j<ny; j++) {
+      patchFactory.insertBoundarySegment({vertex(0, j), vertex(0, j+1)});
+      patchIndex.push_back(1);
+      patchFactory.insertBoundarySegment({vertex(nx, j), vertex(nx, j+1)});
+      patchIndex.push_back(0);
+    }
+    std::shared_ptr<Grid> patchGrid(patchFactory.createGrid());
+    auto patchBasis = makeBasis(patchGrid->leafGridView(), power<dim>(lagrange<p>()));
+    using PatchBasis = decltype(patchBasis);
+
+    Elastodynamics::BoundaryIndexBCAssembler<PatchBasis> patchAssembler(patchBasis, patchIndex);
+    const auto& clamped = patchAssembler.boundaryDofs().dofs(1);
+
+    Range force = {0.3, -0.5};
+    blockVector loadVector(patchBasis.size()), unconstrained(patchBasis.size());
+    loadVector = 0.0, unconstrained = 0.0;
+    patchAssembler.assembleForce(loadVector, force);
+    patchAssembler.patchLoad().addForce(unconstrained, force);
+
+    // the corner carries a load before the clamp is applied, none after it
+    Range corner(0.0), lost(0.0);
+    for(auto row : clamped) {
+      corner += loadVector[row];
+      lost += unconstrained[row];
+    }
+    Range sum = resultant(loadVector);
+    sum += lost;
+    sum -= force;
+    std::cout << "patch next to the clamp: load on clamped dofs " << corner.infinity_norm()
+              << ", share of the clamp " << lost << std::endl;
+    passed = passed and corner.infinity_norm() == 0.0 and lost.infinity_norm() > 0.0;
+    passed = passed and sum.infinity_norm() < 1e-12;
+  }
+
+  return passed ? 0 : 1;
+
+}
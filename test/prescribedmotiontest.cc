@@ -0,0 +1,185 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <cmath>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bdmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+
+#include <dune/elastodynamics/assemblers/operatorassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+#include <dune/elastodynamics/assemblers/hrzlumpedmassassembler.hh>
+
+#include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
+
+#include <dune/elastodynamics/timesteppers/newmark.hh>
+#include <dune/elastodynamics/timesteppers/prescribedmotion.hh>
+#include <dune/elastodynamics/timesteppers/rungekuttanystroem.hh>
+
+// the clamped end of the beam is shaken with g(t) = (a sin(w t), 0): after every
+// step of the compile-time and the runtime Runge-Kutta-Nyström method the
+// constrained dofs carry g(t) and g'(t), and both methods agree. Newmark with
+// the lumped mass (not inverted) also carries g''(t) and follows the same
+// response up to its second order time error.
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // generate Grid
+  using Grid = UGGrid<dim>;
+
+  auto mesh = "beam.msh";
+  std::vector<int> materialIndex, boundaryIndex;
+  GridFactory<Grid> factory;
+  GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+  std::shared_ptr<Grid> grid(factory.createGrid());
+  auto gridView = grid->leafGridView();
+
+  // generate Basis
+  using namespace Functions::BasisBuilder;
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  // define operators needed
+  using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
+  using diagonalType = BDMatrix<FieldMatrix<double, dim, dim>>;
+  using blockVector  = BlockVector<FieldVector<double, dim>>;
+  using Block        = FieldVector<double, dim>;
+
+  // assemble problem
+  Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+
+  double E = 1000000, nu = 0.3;
+  operatorType stiffnessMatrix;
+  operatorAssembler.initialize(stiffnessMatrix);
+  Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu);
+  operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+  double rho = 1.0;
+  diagonalType massMatrix(basis.size());
+  Elastodynamics::HRZLumpedMassAssembler massAssembler(rho);
+  operatorAssembler.assemble(massAssembler, massMatrix, true);
+
+  // row-wise elimination, the kept columns carry the motion into the free dofs
+  Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
+  bcAssembler.assembleMatrix(stiffnessMatrix);
+  bcAssembler.assembleMatrix(massMatrix);
+  operatorType lumpedMassMatrix = massMatrix;
+  massMatrix.invert();
+
+  const auto& constrained = bcAssembler.boundaryDofs().dofs(1);
+  const double a = 0.01, w = 100.0;
+  PrescribedMotion<blockVector> motion;
+  motion.add(constrained,
+             [=](double t) { return Block({a*std::sin(w*t), 0.0}); },
+             [=](double t) { return Block({a*w*std::cos(w*t), 0.0}); },
+             [=](double t) { return Block({-a*w*w*std::sin(w*t), 0.0}); });
+
+  blockVector loadVector(basis.size());
+  loadVector = 0.0;
+
+  double t = 0.0, dt = 0.00001;
+  const int steps = 200;
+
+  // the dofs follow g(t) exactly up to the round-off in t
+  auto check = [&](const blockVector& u, const blockVector& v, double time) {
+    bool follows = true;
+    for(auto d : constrained) {
+      follows = follows and std::abs(u[d][0]-a*std::sin(w*time)) < 1e-14;
+      follows = follows and std::abs(v[d][0]-a*w*std::cos(w*time)) < 1e-12;
+      follows = follows and u[d][1] == 0.0 and v[d][1] == 0.0;
+    }
+    return follows;
+  };
+
+  blockVector displacement(basis.size()), velocity(basis.size()), acceleration(basis.size());
+  displacement = 0.0, velocity = 0.0, acceleration = 0.0;
+  motion.assign(velocity, t, 0.0, 1.0, 0.0);
+  bool followsStatic = true;
+  {
+    FixedStepController fixed(t, dt);
+    RungeKuttaNystroem<operatorType, blockVector, RKN4Tableau, diagonalType> rkn(massMatrix, stiffnessMatrix, fixed);
+    rkn.initialize(loadVector);
+    rkn.setPrescribedMotion(motion);
+    for(int n=1; n<=steps; n++) {
+      rkn.step(displacement, velocity, acceleration, loadVector);
+      followsStatic = followsStatic and check(displacement, velocity, n*dt);
+    }
+  }
+  std::cout << "compile-time tableau follows g(t): " << followsStatic << std::endl;
+
+  blockVector dynamicDisplacement(basis.size()), dynamicVelocity(basis.size());
+  dynamicDisplacement = 0.0, dynamicVelocity = 0.0;
+  motion.assign(dynamicVelocity, t, 0.0, 1.0, 0.0);
+  bool followsDynamic = true;
+  {
+    RKNCoefficients coefficients = RKN4();
+    FixedStepController fixed(t, dt);
+    RungeKuttaNystroem<operatorType, blockVector, DynamicTableau, diagonalType> rkn(massMatrix, stiffnessMatrix, coefficients, fixed);
+    rkn.initialize(loadVector);
+    rkn.setPrescribedMotion(motion);
+    for(int n=1; n<=steps; n++) {
+      rkn.step(dynamicDisplacement, dynamicVelocity, acceleration, loadVector);
+      followsDynamic = followsDynamic and check(dynamicDisplacement, dynamicVelocity, n*dt);
+    }
+  }
+  std::cout << "runtime coefficients follow g(t): " << followsDynamic << std::endl;
+  passed = passed and followsStatic and followsDynamic;
+
+  // the motion reaches the free dofs, both methods give the same response
+  dynamicDisplacement -= displacement;
+  std::cout << "difference between the methods: " << dynamicDisplacement.infinity_norm() << std::endl;
+  passed = passed and displacement.infinity_norm() > 0.0;
+  passed = passed and dynamicDisplacement.infinity_norm() <= 1e-10*displacement.infinity_norm();
+
+  // Newmark: the predictor lifts g into K_fd g and the constrained rows of the
+  // efficient mass return g''(t), the corrector reproduces g and g'
+  blockVector newmarkDisplacement(basis.size()), newmarkVelocity(basis.size());
+  newmarkDisplacement = 0.0, newmarkVelocity = 0.0, acceleration = 0.0;
+  motion.assign(newmarkVelocity, t, 0.0, 1.0, 0.0);
+  bool followsNewmark = true;
+  {
+    NewmarkCoefficients coefficients = ConstantAcceleration();
+    FixedStepController fixed(t, dt);
+    Newmark<operatorType, blockVector> newmark(lumpedMassMatrix, stiffnessMatrix, coefficients, fixed);
+    newmark.setPrescribedMotion(motion);
+    newmark.initialize(acceleration, loadVector);
+    for(int n=1; n<=steps; n++) {
+      newmark.step(newmarkDisplacement, newmarkVelocity, acceleration, loadVector);
+      const double time = n*dt;
+      for(auto d : constrained) {
+        followsNewmark = followsNewmark and std::abs(newmarkDisplacement[d][0]-a*std::sin(w*time)) < 1e-12;
+        followsNewmark = followsNewmark and std::abs(newmarkVelocity[d][0]-a*w*std::cos(w*time)) < 1e-10;
+        followsNewmark = followsNewmark and std::abs(acceleration[d][0]+a*w*w*std::sin(w*time)) < 1e-8;
+        followsNewmark = followsNewmark and newmarkDisplacement[d][1] == 0.0 and acceleration[d][1] == 0.0;
+      }
+    }
+  }
+  std::cout << "newmark follows g(t): " << followsNewmark << std::endl;
+  passed = passed and followsNewmark;
+
+  newmarkDisplacement -= displacement;
+  std::cout << "difference between newmark and rkn: " << newmarkDisplacement.infinity_norm() << std::endl;
+  passed = passed and newmarkDisplacement.infinity_norm() <= 1e-1*displacement.infinity_norm();
+
+  return passed ? 0 : 1;
+
+}
@@ -0,0 +1,276 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <cmath>
+#include <random>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bdmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+#include <dune/functions/functionspacebases/interpolate.hh>
+
+#include <dune/elastodynamics/assemblers/operatorassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+#include <dune/elastodynamics/assemblers/lobattolumpedmassassembler.hh>
+#include <dune/elastodynamics/assemblers/spectralelementoperator.hh>
+
+#include <dune/elastodynamics/quadraturerules/lumpingquadrature.hh>
+
+#include <dune/elastodynamics/timesteppers/rungekuttanystroem.hh>
+
+// the matrix-free SpectralElementOperator on a structured quadrilateral grid for
+// p = 1, ..., 4 against the assembled lagrange<p> operators with the same
+// Gauss-Lobatto rule, transformed to the GLL nodes (T^T A T, identity for p <= 2):
+// - mv equals the StiffnessAssembler matrix times a random vector
+// - lumpedMass equals the Gauss-Lobatto mass, which is diagonal on the GLL
+//   nodes, and the LobattoLumpedMassAssembler matrix for p <= 2
+// - a Runge-Kutta-Nyström run with a BDMatrix mass gives the same response
+// - lagrangeCoefficients reproduces the interpolant of a polynomial of order p
+
+using namespace Dune;
+const int dim = 2;
+
+// mass with the Gauss-Lobatto rule of the element for any Lagrange basis, not
+// diagonal for the equidistant nodes of p > 2
+struct GaussLobattoMassAssembler {
+
+  typedef typename Dune::Matrix<Dune::FieldMatrix<double, 1, 1>> LocalMatrix;
+
+  double rho;
+
+  template <class LocalView>
+  void assemble(LocalMatrix& localMatrix, LocalView& localView) {
+    const auto& localFE = localView.tree().child(0).finiteElement();
+    const auto geometry = localView.element().geometry();
+    const auto& quadRule = LumpingQuadratureRules<double, dim>::rule(localView.element().type(),
+                                                                    localFE.localBasis().order());
+    localMatrix.setSize(localView.size(), localView.size());
+    localMatrix = 0.0;
+    std::vector<FieldVector<double, 1>> values(localFE.size());
+    for(const auto& quadPoint : quadRule) {
+      localFE.localBasis().evaluateFunction(quadPoint.position(), values);
+      const double weight = quadPoint.weight()*rho*geometry.integrationElement(quadPoint.position());
+      for(std::size_t i=0; i<localFE.size(); i++)
+        for(std::size_t j=0; j<localFE.size(); j++)
+          for(int k=0; k<dim; k++)
+            localMatrix[localView.tree().child(k).localIndex(i)][localView.tree().child(k).localIndex(j)]
+              += weight*values[i]*values[j];
+    }
+  }
+};
+
+// T^T A T with identity rows on the constrained dofs, an assembled lagrange<p>
+// matrix on the GLL nodes
+template<class Operator, class Matrix>
+struct TransformedMatrix {
+
+  const Operator& transform;
+  const Matrix& matrix;
+  std::vector<bool> constrained;
+
+  template<class VectorType>
+  void usmv(double alpha, const VectorType& x, VectorType& y) const
+  {
+    VectorType Tx, ATx(x.size()), TtATx;
+    transform.lagrangeCoefficients(x, Tx);
+    matrix.mv(Tx, ATx);
+    transform.nodalLoads(ATx, TtATx);
+    for(std::size_t i=0; i<x.size(); i++)
+      y[i].axpy(alpha, constrained.empty() or !constrained[i] ? TtATx[i] : x[i]);
+  }
+
+  template<class VectorType>
+  void umv(const VectorType& x, VectorType& y) const { usmv(1.0, x, y); }
+
+  template<class VectorType>
+  void mmv(const VectorType& x, VectorType& y) const { usmv(-1.0, x, y); }
+
+  template<class VectorType>
+  void mv(const VectorType& x, VectorType& y) const
+  {
+    y = 0.0;
+    usmv(1.0, x, y);
+  }
+};
+
+template <int p, class GridView>
+bool test(const GridView& gridView) {
+
+  bool passed = true;
+
+  // generate Basis
+  using namespace Functions::BasisBuilder;
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  // define operators needed
+  using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
+  using diagonalType = BDMatrix<FieldMatrix<double, dim, dim>>;
+  using blockVector  = BlockVector<FieldVector<double, dim>>;
+  using Coordinate   = FieldVector<double, dim>;
+  using Operator     = Elastodynamics::SpectralElementOperator<Basis>;
+
+  double E = 1000000, nu = 0.3, rho = 1.0;
+  Operator stiffnessOperator(basis, E, nu, rho);
+
+  // assembled operators
+  Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+
+  operatorType stiffnessMatrix;
+  operatorAssembler.initialize(stiffnessMatrix);
+  Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu, Elastodynamics::PlaneAssumption::strain,
+                                                      QuadratureType::GaussLobatto);
+  operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+  operatorType massMatrix;
+  operatorAssembler.initialize(massMatrix);
+  GaussLobattoMassAssembler massAssembler{rho};
+  operatorAssembler.assemble(massAssembler, massMatrix, false);
+
+  using Transformed = TransformedMatrix<Operator, operatorType>;
+  const Transformed transformedStiffness{stiffnessOperator, stiffnessMatrix, {}};
+  const Transformed transformedMass{stiffnessOperator, massMatrix, {}};
+
+  std::mt19937 generator(p);
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  blockVector x(basis.size());
+  for(auto& block : x)
+    for(auto& value : block)
+      value = distribution(generator);
+
+  // stiffness times a random vector
+  {
+    blockVector y(basis.size()), z(basis.size());
+    transformedStiffness.mv(x, y);
+    stiffnessOperator.mv(x, z);
+    z -= y;
+    std::cout << "p = " << p << ", stiffness error: " << z.infinity_norm() << std::endl;
+    passed = passed and z.infinity_norm() <= 1e-12*y.infinity_norm();
+  }
+
+  // diagonal mass, the Gauss-Lobatto mass on the GLL nodes times a random vector
+  diagonalType lumpedMass(basis.size());
+  stiffnessOperator.lumpedMass(lumpedMass);
+  {
+    blockVector y(basis.size()), z(basis.size());
+    transformedMass.mv(x, y);
+    lumpedMass.mv(x, z);
+    z -= y;
+    std::cout << "p = " << p << ", mass error: " << z.infinity_norm() << std::endl;
+    passed = passed and z.infinity_norm() <= 1e-12*y.infinity_norm();
+  }
+
+  if constexpr (p <= 2) {
+    diagonalType lobattoMass(basis.size());
+    Elastodynamics::LobattoLumpedMassAssembler lobattoAssembler(rho);
+    operatorAssembler.assemble(lobattoAssembler, lobattoMass, true);
+
+    double error = 0.0, scale = 0.0;
+    for(std::size_t i=0; i<basis.size(); i++) {
+      auto difference = lumpedMass[i][i];
+      difference -= lobattoMass[i][i];
+      error = std::max(error, difference.infnorm());
+      scale = std::max(scale, lobattoMass[i][i].infnorm());
+    }
+    passed = passed and error <= 1e-12*scale;
+  }
+
+  // GLL nodal values of a polynomial of order p against the lagrange<p> interpolant
+  auto polynomial = [](const Coordinate& x) {
+    return FieldVector<double, dim>({std::pow(x[0], p) - x[1], x[0]*std::pow(x[1], p)});
+  };
+  {
+    blockVector nodal, y, z(basis.size());
+    stiffnessOperator.interpolate(nodal, polynomial);
+    stiffnessOperator.lagrangeCoefficients(nodal, y);
+    Functions::interpolate(basis, z, polynomial);
+    z -= y;
+    std::cout << "p = " << p << ", lagrange coefficients error: " << z.infinity_norm() << std::endl;
+    passed = passed and z.infinity_norm() <= 1e-12;
+  }
+
+  // clamped at x = 0, pulled down at x = 1, the node positions are the GLL points
+  BlockVector<Coordinate> coordinates;
+  stiffnessOperator.interpolate(coordinates, [](const Coordinate& x) { return x; });
+  std::vector<std::size_t> constrained;
+  blockVector loadVector(basis.size());
+  loadVector = 0.0;
+  for(std::size_t i=0; i<basis.size(); i++) {
+    if(coordinates[i][0] < 1e-10)
+      constrained.push_back(i);
+    if(coordinates[i][0] > 1.0-1e-10)
+      loadVector[i] = {0.0, -1.0};
+  }
+
+  FieldMatrix<double, dim, dim> I(0.0);
+  for(int k=0; k<dim; k++)
+    I[k][k] = 1.0;
+  stiffnessOperator.setConstrained(constrained);
+  Transformed constrainedStiffness{stiffnessOperator, stiffnessMatrix, std::vector<bool>(basis.size(), false)};
+  for(auto row : constrained) {
+    constrainedStiffness.constrained[row] = true;
+    lumpedMass[row][row] = I;
+    loadVector[row] = 0.0;
+  }
+  lumpedMass.invert();
+
+  double t = 0.0, dt = 0.000001;
+  const int steps = 100;
+
+  blockVector displacement(basis.size()), velocity(basis.size()), acceleration(basis.size());
+  displacement = 0.0, velocity = 0.0, acceleration = 0.0;
+  {
+    FixedStepController fixed(t, dt);
+    RungeKuttaNystroem<Operator, blockVector, RKN4Tableau, diagonalType> rkn(lumpedMass, stiffnessOperator, fixed);
+    rkn.initialize(loadVector);
+    for(int n=0; n<steps; n++)
+      rkn.step(displacement, velocity, acceleration, loadVector);
+  }
+
+  blockVector matrixDisplacement(basis.size()), matrixVelocity(basis.size());
+  matrixDisplacement = 0.0, matrixVelocity = 0.0;
+  {
+    FixedStepController fixed(t, dt);
+    RungeKuttaNystroem<Transformed, blockVector, RKN4Tableau, diagonalType> rkn(lumpedMass, constrainedStiffness, fixed);
+    rkn.initialize(loadVector);
+    for(int n=0; n<steps; n++)
+      rkn.step(matrixDisplacement, matrixVelocity, acceleration, loadVector);
+  }
+
+  matrixDisplacement -= displacement;
+  std::cout << "p = " << p << ", difference to the assembled stiffness: "
+            << matrixDisplacement.infinity_norm() << std::endl;
+  passed = passed and displacement.infinity_norm() > 0.0;
+  passed = passed and matrixDisplacement.infinity_norm() <= 1e-10*displacement.infinity_norm();
+
+  return passed;
+}
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // generate Grid
+  using Grid = YaspGrid<dim>;
+  Grid grid({1.0, 0.25}, {8, 2});
+  auto gridView = grid.leafGridView();
+
+  passed = passed and test<1>(gridView);
+  passed = passed and test<2>(gridView);
+  passed = passed and test<3>(gridView);
+  passed = passed and test<4>(gridView);
+
+  return passed ? 0 : 1;
+
+}
@@ -0,0 +1,264 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bvector.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+#include <dune/functions/functionspacebases/interpolate.hh>
+
+#include <dune/elastodynamics/assemblers/elasticitykernels.hh>
+#include <dune/elastodynamics/assemblers/materialtable.hh>
+#include <dune/elastodynamics/utilities/stressrecovery.hh>
+
+// stress recovery on the quadrilaterals of the beam:
+// - a linear displacement gives the exact constant strain and stress at the
+//   quadrature points and the nodes, the von Mises stress includes
+//   sigma_zz = nu (sigma_xx + sigma_yy) for plane strain and none for plane stress
+// - a hat function of one vertex has a different gradient in every element, the
+//   nodal value at the vertex is the mean of the element values
+// - with a MaterialTable of two physical groups (x < 3 and x > 3) the linear
+//   displacement gives the stress of each group's material at its quadrature
+//   points and the von Mises stress with its nu at the nodes inside a group
+
+using namespace Dune;
+const int dim = 2;
+
+using Tensor = SymmetricTensor<dim>;
+
+// sqrt(3 J2) of the deviatoric part
+double vonMisesOf(const Tensor& s, double szz) {
+  const double mean = (s(0,0) + s(1,1) + szz)/3.0;
+  const double dxx = s(0,0)-mean, dyy = s(1,1)-mean, dzz = szz-mean;
+  return std::sqrt(3.0*(0.5*(dxx*dxx + dyy*dyy + dzz*dzz) + s(0,1)*s(0,1)));
+}
+
+double difference(Tensor a, const Tensor& b) {
+  a -= b;
+  return a.infinity_norm();
+}
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // generate Grid
+  using Grid = UGGrid<dim>;
+
+  auto mesh = "beam.msh";
+  std::vector<int> materialIndex, boundaryIndex;
+  GridFactory<Grid> factory;
+  GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+  std::shared_ptr<Grid> grid(factory.createGrid());
+  auto gridView = grid->leafGridView();
+
+  using namespace Functions::BasisBuilder;
+  using Coordinate = FieldVector<double, dim>;
+  using blockVector = BlockVector<FieldVector<double, dim>>;
+
+  double E = 1000000, nu = 0.3;
+
+  // linear displacement u = A x + b
+  {
+    auto basis = makeBasis(gridView, power<dim>(lagrange<2>()));
+    using Basis = decltype(basis);
+
+    const FieldMatrix<double, dim, dim> A = {{1e-3, 2e-3}, {-5e-4, 3e-3}};
+    const Coordinate b = {0.1, 0.2};
+    blockVector u(basis.size());
+    Functions::interpolate(basis, u, [&](const Coordinate& x) {
+      Coordinate y = b;
+      A.umv(x, y);
+      return y;
+    });
+
+    Tensor strain;
+    strain(0,0) = A[0][0];
+    strain(1,1) = A[1][1];
+    strain(0,1) = 0.5*(A[0][1] + A[1][0]);
+
+    for(auto assumption : {Elastodynamics::PlaneAssumption::strain, Elastodynamics::PlaneAssumption::stress}) {
+      const Elastodynamics::IsotropicMaterial<dim> material(E, nu, assumption);
+      Elastodynamics::StressRecovery<Basis> recovery(basis, material, nu, assumption);
+
+      Tensor stress;
+      material.stress(strain, stress);
+      const double szz = assumption == Elastodynamics::PlaneAssumption::strain ? nu*(stress(0,0) + stress(1,1)) : 0.0;
+      const double expectedVonMises = vonMisesOf(stress, szz);
+
+      std::vector<Tensor> quadratureStrain, quadratureStress, nodalStrain, nodalStress;
+      recovery.quadratureStrain(u, quadratureStrain);
+      recovery.quadratureStress(u, quadratureStress);
+      recovery.nodalStrain(u, nodalStrain);
+      recovery.nodalStress(u, nodalStress);
+
+      double strainError = 0.0, stressError = 0.0;
+      for(std::size_t q=0; q<quadratureStrain.size(); q++) {
+        strainError = std::max(strainError, difference(quadratureStrain[q], strain));
+        stressError = std::max(stressError, difference(quadratureStress[q], stress));
+      }
+      for(std::size_t i=0; i<nodalStrain.size(); i++) {
+        strainError = std::max(strainError, difference(nodalStrain[i], strain));
+        stressError = std::max(stressError, difference(nodalStress[i], stress));
+      }
+
+      BlockVector<FieldVector<double, 1>> vonMisesStress;
+      recovery.nodalVonMises(u, vonMisesStress);
+      double vonMisesError = 0.0;
+      for(std::size_t i=0; i<vonMisesStress.size(); i++)
+        vonMisesError = std::max(vonMisesError, std::abs(vonMisesStress[i][0]-expectedVonMises));
+
+      std::cout << (assumption == Elastodynamics::PlaneAssumption::strain ? "plane strain" : "plane stress")
+                << ": strain error " << strainError << ", stress error " << stressError
+                << ", von Mises error " << vonMisesError << std::endl;
+      passed = passed and !quadratureStrain.empty() and nodalStrain.size() == basis.size();
+      passed = passed and strainError < 1e-12*strain.infinity_norm();
+      passed = passed and stressError < 1e-12*stress.infinity_norm();
+      passed = passed and vonMisesError < 1e-12*expectedVonMises;
+    }
+  }
+
+  // a hat function of the vertex shared by the most elements
+  {
+    auto basis = makeBasis(gridView, power<dim>(lagrange<1>()));
+    using Basis = decltype(basis);
+    auto localView = basis.localView();
+
+    std::vector<int> count(basis.size(), 0);
+    for(const auto& element : elements(gridView)) {
+      localView.bind(element);
+      const auto& node = localView.tree().child(0);
+      for(std::size_t k=0; k<node.size(); k++)
+        count[localView.index(node.localIndex(k))[0]]++;
+    }
+    const std::size_t target = std::max_element(count.begin(), count.end()) - count.begin();
+
+    blockVector u(basis.size());
+    u = 0.0;
+    u[target] = {1.0, 0.5};
+
+    // the gradient of the bilinear hat at its own vertex k of the reference
+    // square is (+-1, +-1), mapped with the element geometry
+    Tensor expected(0.0), first(0.0);
+    int elementsAtTarget = 0;
+    for(const auto& element : elements(gridView)) {
+      localView.bind(element);
+      const auto& node = localView.tree().child(0);
+      const auto geometry = element.geometry();
+      for(std::size_t k=0; k<node.size(); k++) {
+        if(localView.index(node.localIndex(k))[0] != target)
+          continue;
+        const Coordinate x = {double(k & 1), double((k >> 1) & 1)};
+        const Coordinate referenceGradient = {(k & 1) ? 1.0 : -1.0, (k & 2) ? 1.0 : -1.0};
+        Coordinate gradient;
+        geometry.jacobianInverseTransposed(x).mv(referenceGradient, gradient);
+        Tensor strain;
+        strain(0,0) = u[target][0]*gradient[0];
+        strain(1,1) = u[target][1]*gradient[1];
+        strain(0,1) = 0.5*(u[target][0]*gradient[1] + u[target][1]*gradient[0]);
+        if(elementsAtTarget == 0)
+          first = strain;
+        expected += strain;
+        elementsAtTarget++;
+      }
+    }
+    expected /= double(elementsAtTarget);
+
+    const Elastodynamics::IsotropicMaterial<dim> material(E, nu);
+    Elastodynamics::StressRecovery<Basis> recovery(basis, material, nu);
+    std::vector<Tensor> nodalStrain, nodalStress;
+    std::vector<double> nodalStressZZ;
+    recovery.nodalStrain(u, nodalStrain);
+    recovery.nodalStress(u, nodalStress);
+    recovery.nodalStressZZ(u, nodalStressZZ);
+
+    Tensor expectedStress;
+    material.stress(expected, expectedStress);
+    const double strainError = difference(nodalStrain[target], expected);
+    const double stressError = difference(nodalStress[target], expectedStress);
+    const double zzError = std::abs(nodalStressZZ[target]-nu*(expectedStress(0,0) + expectedStress(1,1)));
+    std::cout << "shared vertex of " << elementsAtTarget << " elements: strain error " << strainError
+              << ", stress error " << stressError << ", sigma_zz error " << zzError << std::endl;
+    passed = passed and elementsAtTarget > 1;
+    passed = passed and difference(first, expected) > 1e-3*expected.infinity_norm();
+    passed = passed and strainError < 1e-12*expected.infinity_norm();
+    passed = passed and stressError < 1e-12*expectedStress.infinity_norm();
+    passed = passed and zzError < 1e-12*expectedStress.infinity_norm();
+  }
+
+  // two materials from the physical groups
+  {
+    auto basis = makeBasis(gridView, power<dim>(lagrange<2>()));
+    using Basis = decltype(basis);
+
+    std::vector<int> groups = materialIndex;
+    for(const auto& element : elements(gridView))
+      groups[factory.insertionIndex(element)] = element.geometry().center()[0] < 3.0 ? 1 : 2;
+    const std::map<int, Elastodynamics::Material> materials = {{1, {E, nu, 1.0}}, {2, {5*E, 0.25, 1.0}}};
+    Elastodynamics::MaterialTable<decltype(gridView)> table(gridView, factory, groups, materials);
+    Elastodynamics::StressRecovery<Basis> recovery(basis, table);
+
+    const FieldMatrix<double, dim, dim> A = {{1e-3, 2e-3}, {-5e-4, 3e-3}};
+    blockVector u(basis.size());
+    Functions::interpolate(basis, u, [&](const Coordinate& x) {
+      Coordinate y(0.0);
+      A.umv(x, y);
+      return y;
+    });
+    BlockVector<Coordinate> coordinates(basis.size());
+    Functions::interpolate(basis, coordinates, [](const Coordinate& x) { return x; });
+
+    Tensor strain;
+    strain(0,0) = A[0][0];
+    strain(1,1) = A[1][1];
+    strain(0,1) = 0.5*(A[0][1] + A[1][0]);
+    std::map<int, Tensor> stress;
+    std::map<int, double> expectedVonMises;
+    double scale = 0.0;
+    for(const auto& [group, material] : materials) {
+      Elastodynamics::IsotropicMaterial<dim>(material.E, material.nu).stress(strain, stress[group]);
+      expectedVonMises[group] = vonMisesOf(stress[group], material.nu*(stress[group](0,0) + stress[group](1,1)));
+      scale = std::max(scale, stress[group].infinity_norm());
+    }
+
+    std::vector<Tensor> quadratureStress;
+    recovery.quadratureStress(u, quadratureStress);
+    double stressError = 0.0;
+    std::size_t q = 0;
+    for(const auto& element : elements(gridView)) {
+      const int group = element.geometry().center()[0] < 3.0 ? 1 : 2;
+      const auto points = QuadratureRules<double, dim>::rule(element.type(), 4).size();
+      for(std::size_t k=0; k<points; k++, q++)
+        stressError = std::max(stressError, difference(quadratureStress[q], stress[group]));
+    }
+
+    BlockVector<FieldVector<double, 1>> vonMisesStress;
+    recovery.nodalVonMises(u, vonMisesStress);
+    double vonMisesError = 0.0;
+    for(std::size_t i=0; i<vonMisesStress.size(); i++)
+      if(std::abs(coordinates[i][0]-3.0) > 1e-8) {
+        const int group = coordinates[i][0] < 3.0 ? 1 : 2;
+        vonMisesError = std::max(vonMisesError, std::abs(vonMisesStress[i][0]-expectedVonMises[group]));
+      }
+
+    std::cout << "material table: stress error " << stressError << ", von Mises error " << vonMisesError << std::endl;
+    passed = passed and q == quadratureStress.size();
+    passed = passed and stressError < 1e-12*scale and vonMisesError < 1e-12*scale;
+  }
+
+  return passed ? 0 : 1;
+
+}
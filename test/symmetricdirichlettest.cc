@@ -0,0 +1,105 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/umfpack.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+
+#include <dune/elastodynamics/assemblers/operatorassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+
+#include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+  
+  // generate Grid
+  using Grid = UGGrid<dim>;
+  
+  auto mesh = "beam.msh";
+  std::vector<int> materialIndex, boundaryIndex;
+  GridFactory<Grid> factory;
+  GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+  std::shared_ptr<Grid> grid(factory.createGrid());    
+  auto gridView = grid->leafGridView();
+  
+  // generate Basis
+  using namespace Functions::BasisBuilder;
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  // define operators needed
+  using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
+  using blockVector  = BlockVector<FieldVector<double, dim>>;
+
+  // assemble problem
+  operatorType stiffnessMatrix;
+  double E = 1000000, nu = 0.3;
+  
+  Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+  operatorAssembler.initialize(stiffnessMatrix);
+  Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu);
+  operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+  // prescribed displacement of the clamped end, load at the free end
+  Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
+
+  blockVector prescribed(basis.size()), loadVector(basis.size());
+  prescribed = 0.0, loadVector = 0.0;
+  for(auto i : bcAssembler.boundaryDofs().dofs(1))
+    prescribed[i] = {0.001, 0.01};
+  for(auto i : bcAssembler.boundaryDofs().vertexDofs(2))
+    loadVector[i] = {0.0, 0.5};
+
+  // row-wise elimination
+  operatorType rowMatrix(stiffnessMatrix);
+  blockVector rowLoad(loadVector), rowSolution(basis.size());
+  bcAssembler.assembleMatrix(rowMatrix);
+  for(auto i : bcAssembler.boundaryDofs().dofs(1))
+    rowLoad[i] = prescribed[i];
+
+  // symmetric elimination with lifting
+  operatorType symmetricMatrix(stiffnessMatrix);
+  blockVector symmetricLoad(loadVector), symmetricSolution(basis.size());
+  auto elimination = bcAssembler.assembleMatrixSymmetric(symmetricMatrix);
+  elimination.lift(symmetricLoad, prescribed);
+
+  // the eliminated matrix has to be symmetric
+  double asymmetry = 0.0;
+  for(auto row = symmetricMatrix.begin(); row != symmetricMatrix.end(); ++row)
+    for(auto col = row->begin(); col != row->end(); ++col)
+      for(int k=0; k<dim; k++)
+        for(int l=0; l<dim; l++)
+          asymmetry = std::max(asymmetry, std::abs((*col)[k][l] - symmetricMatrix[col.index()][row.index()][l][k]));
+  passed = passed and asymmetry < 1e-12*E;
+
+  // ... and give the same solution
+  InverseOperatorResult statistics;
+  UMFPack<operatorType> rowSolver(rowMatrix);
+  rowSolver.apply(rowSolution, rowLoad, statistics);
+  UMFPack<operatorType> symmetricSolver(symmetricMatrix);
+  symmetricSolver.apply(symmetricSolution, symmetricLoad, statistics);
+
+  symmetricSolution -= rowSolution;
+  passed = passed and symmetricSolution.infinity_norm() < 1e-10*rowSolution.infinity_norm();
+
+  return passed ? 0 : 1;
+
+}
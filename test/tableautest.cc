@@ -0,0 +1,182 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bdmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+
+#include <dune/elastodynamics/assemblers/operatorassembler.hh>
+#include <dune/elastodynamics/assemblers/stiffnessassembler.hh>
+#include <dune/elastodynamics/assemblers/hrzlumpedmassassembler.hh>
+
+#include <dune/elastodynamics/utilities/boundaryindexbcassembler.hh>
+
+#include <dune/elastodynamics/timesteppers/rungekuttanystroem.hh>
+#include <dune/elastodynamics/timesteppers/embeddedrungekuttanystroem.hh>
+
+// the unrolled steppers with a compile-time tableau have to reproduce the
+// runtime steppers up to round-off, for the embedded pairs also the error
+// estimate, i.e. the step sizes chosen by the adaptive controller
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+using operatorType = BCRSMatrix<FieldMatrix<double, dim, dim>>;
+using diagonalType = BDMatrix<FieldMatrix<double, dim, dim>>;
+using blockVector  = BlockVector<FieldVector<double, dim>>;
+
+template <class Tableau>
+bool compareFixed(diagonalType& mass, operatorType& stiffness, blockVector& load,
+                  RKNCoefficients coefficients, const std::string& name)
+{
+  const double t = 0.0, dt = 0.00001;
+  const int steps = 50;
+
+  blockVector u(load.size()), v(load.size()), a(load.size());
+  u = 0.0, v = 0.0, a = 0.0;
+  {
+    FixedStepController fixed(t, dt);
+    RungeKuttaNystroem<operatorType, blockVector> rkn(mass, stiffness, coefficients, fixed);
+    rkn.initialize(load);
+    for(int n=0; n<steps; n++)
+      rkn.step(u, v, a, load);
+  }
+
+  blockVector uTableau(load.size()), vTableau(load.size());
+  uTableau = 0.0, vTableau = 0.0;
+  {
+    FixedStepController fixed(t, dt);
+    RungeKuttaNystroem<operatorType, blockVector, Tableau, diagonalType> rkn(mass, stiffness, fixed);
+    rkn.initialize(load);
+    for(int n=0; n<steps; n++)
+      rkn.step(uTableau, vTableau, a, load);
+  }
+
+  uTableau -= u;
+  vTableau -= v;
+  std::cout << name << ": " << uTableau.infinity_norm() << ", " << vTableau.infinity_norm() << std::endl;
+  return u.infinity_norm() > 0.0
+    and uTableau.infinity_norm() <= 1e-12*u.infinity_norm()
+    and vTableau.infinity_norm() <= 1e-12*v.infinity_norm();
+}
+
+template <class Tableau>
+bool compareEmbedded(diagonalType& mass, operatorType& stiffness, blockVector& load,
+                     const std::vector<std::size_t>& constrained,
+                     EmbeddedRKNCoefficients coefficients, const std::string& name)
+{
+  const double t = 0.0, dt = 0.00001, tol = 1e-8;
+  const int steps = 20;
+
+  // a rough initial displacement excites the high modes, so the error
+  // estimate is well above round-off
+  blockVector u(load.size()), v(load.size()), a(load.size());
+  v = 0.0, a = 0.0;
+  for(std::size_t i=0; i<u.size(); i++)
+    u[i] = {1e-4*((3*i)%5), 1e-4*((7*i)%3)};
+  for(auto i : constrained)
+    u[i] = 0.0;
+  blockVector uTableau = u, vTableau = v;
+
+  AdaptiveStepController adaptive(t, dt, tol), adaptiveTableau(t, dt, tol);
+  EmbeddedRungeKuttaNystroem<operatorType, blockVector> rkn(mass, stiffness, coefficients, &adaptive);
+  EmbeddedRungeKuttaNystroem<operatorType, blockVector, Tableau> rknTableau(mass, stiffness, &adaptiveTableau);
+  rkn.initialize(load);
+  rknTableau.initialize(load);
+
+  // the next step size follows from the error estimate of the accepted step,
+  // the estimate is a difference of two solutions and loses some digits
+  double stepDifference = 0.0;
+  for(int n=0; n<steps; n++) {
+    rkn.step(u, v, a, load);
+    rknTableau.step(uTableau, vTableau, a, load);
+    stepDifference = std::max(stepDifference, std::abs(adaptive.deltaT() - adaptiveTableau.deltaT())/adaptive.deltaT());
+    stepDifference = std::max(stepDifference, std::abs(adaptive.time() - adaptiveTableau.time())/adaptive.time());
+  }
+
+  uTableau -= u;
+  vTableau -= v;
+  std::cout << name << ": " << uTableau.infinity_norm() << ", " << vTableau.infinity_norm()
+            << ", step sizes " << stepDifference << std::endl;
+  return u.infinity_norm() > 0.0
+    and adaptive.deltaT() != dt
+    and stepDifference <= 1e-8
+    and uTableau.infinity_norm() <= 1e-10*u.infinity_norm()
+    and vTableau.infinity_norm() <= 1e-10*v.infinity_norm();
+}
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  // generate Grid
+  using Grid = UGGrid<dim>;
+
+  auto mesh = "beam.msh";
+  std::vector<int> materialIndex, boundaryIndex;
+  GridFactory<Grid> factory;
+  GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+  std::shared_ptr<Grid> grid(factory.createGrid());
+  auto gridView = grid->leafGridView();
+
+  // generate Basis
+  using namespace Functions::BasisBuilder;
+  auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+  using Basis = decltype(basis);
+
+  // assemble problem
+  Elastodynamics::OperatorAssembler<Basis> operatorAssembler(basis);
+
+  double E = 1000000, nu = 0.3;
+  operatorType stiffnessMatrix;
+  operatorAssembler.initialize(stiffnessMatrix);
+  Elastodynamics::StiffnessAssembler stiffnessAssembler(E, nu);
+  operatorAssembler.assemble(stiffnessAssembler, stiffnessMatrix, false);
+
+  double rho = 1.0;
+  diagonalType massMatrix(basis.size());
+  Elastodynamics::HRZLumpedMassAssembler massAssembler(rho);
+  operatorAssembler.assemble(massAssembler, massMatrix, true);
+
+  Elastodynamics::BoundaryIndexBCAssembler<Basis> bcAssembler(basis, boundaryIndex);
+  bcAssembler.assembleMatrix(stiffnessMatrix);
+  bcAssembler.assembleMatrix(massMatrix);
+  massMatrix.invert();
+
+  blockVector loadVector(basis.size());
+  loadVector = 0.0;
+  for(auto i : bcAssembler.boundaryDofs().vertexDofs(2))
+    loadVector[i] = {0.0, 0.5};
+
+  passed = passed and compareFixed<RKN4Tableau>(massMatrix, stiffnessMatrix, loadVector, RKN4(), "RKN4");
+  passed = passed and compareFixed<RKN5Tableau>(massMatrix, stiffnessMatrix, loadVector, RKN5(), "RKN5");
+
+  const auto& constrained = bcAssembler.boundaryDofs().dofs(1);
+  passed = passed and compareEmbedded<BettisRKN45Tableau>(massMatrix, stiffnessMatrix, loadVector, constrained,
+                                                          BettisRKN45(), "BettisRKN45");
+  passed = passed and compareEmbedded<DPRKN64Tableau>(massMatrix, stiffnessMatrix, loadVector, constrained,
+                                                      DPRKN64(), "DPRKN64");
+  passed = passed and compareEmbedded<DPRKN86Tableau>(massMatrix, stiffnessMatrix, loadVector, constrained,
+                                                      DPRKN86(), "DPRKN86");
+
+  return passed ? 0 : 1;
+
+}
@@ -0,0 +1,158 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+#include <cmath>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/geometry/quadraturerules.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/io/file/gmshreader.hh>
+
+#include <dune/istl/bvector.hh>
+
+#include <dune/functions/functionspacebases/basistags.hh>
+#include <dune/functions/functionspacebases/powerbasis.hh>
+#include <dune/functions/functionspacebases/lagrangebasis.hh>
+#include <dune/functions/functionspacebases/interpolate.hh>
+
+// the module does not ship a BoundaryPatch (dune-fufem), the BoundaryAssembler
+// only needs the intersections of the patch
+namespace Dune {
+  template<class GridView>
+  class BoundaryPatch {
+    private:
+      std::vector<typename GridView::Intersection> intersections_;
+    public:
+      void add(const typename GridView::Intersection& intersection)
+      { intersections_.push_back(intersection); }
+      auto begin() const { return intersections_.begin(); }
+      auto end() const { return intersections_.end(); }
+  };
+}
+
+#include <dune/elastodynamics/utilities/boundaryassembler.hh>
+#include <dune/elastodynamics/utilities/neumannboundary.hh>
+#include <dune/elastodynamics/utilities/tractionassembler.hh>
+
+// - a pressure on an inclined face has the resultant -n int p ds
+// - addScaled(s) after setReferencePressure(p) equals assemblePressure(s p)
+// - the BoundaryAssembler sums the Neumann loads of dofs shared by two faces
+
+using namespace Dune;
+const int dim = 2;
+const int p = 2;
+
+int main(int argc, char** argv) {
+
+  const MPIHelper& mpiHelper = MPIHelper::instance(argc, argv);
+  bool passed = true;
+
+  using Grid = UGGrid<dim>;
+  using Range = FieldVector<double, dim>;
+  using blockVector = BlockVector<FieldVector<double, dim>>;
+  using namespace Functions::BasisBuilder;
+
+  // trapezoid (0,0), (1,0), (2,1), (0,1), the face from (1,0) to (2,1) has the
+  // outer normal (1,-1)/sqrt(2) and the length sqrt(2)
+  {
+    GridFactory<Grid> factory;
+    factory.insertVertex({0.0, 0.0});
+    factory.insertVertex({1.0, 0.0});
+    factory.insertVertex({0.0, 1.0});
+    factory.insertVertex({2.0, 1.0});
+    factory.insertElement(GeometryTypes::quadrilateral, {0, 1, 2, 3});
+    std::vector<int> boundaryIndex;
+    factory.insertBoundarySegment({0, 1});
+    boundaryIndex.push_back(0);
+    factory.insertBoundarySegment({1, 3});
+    boundaryIndex.push_back(2);
+    factory.insertBoundarySegment({3, 2});
+    boundaryIndex.push_back(3);
+    factory.insertBoundarySegment({2, 0});
+    boundaryIndex.push_back(1);
+    std::shared_ptr<Grid> grid(factory.createGrid());
+    grid->globalRefine(2);
+    auto gridView = grid->leafGridView();
+    auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+
+    Elastodynamics::TractionAssembler<decltype(basis)> traction(basis, boundaryIndex, 2);
+
+    // p(x) = y, int p ds = sqrt(2)/2, the resultant is (-1/2, 1/2)
+    auto pressure = [](const Range& x) { return x[1]; };
+    blockVector b(basis.size());
+    b = 0.0;
+    traction.assemblePressure(b, pressure);
+    Range resultant(0.0);
+    for(std::size_t i=0; i<b.size(); i++)
+      resultant += b[i];
+    std::cout << "pressure resultant on the inclined face: " << resultant
+              << ", length " << traction.area() << std::endl;
+    passed = passed and std::abs(traction.area()-std::sqrt(2.0)) < 1e-12;
+    passed = passed and std::abs(resultant[0]+0.5) < 1e-12 and std::abs(resultant[1]-0.5) < 1e-12;
+
+    // scaled reference load
+    const double scale = 3.7;
+    blockVector scaled(basis.size()), direct(basis.size());
+    scaled = 0.0, direct = 0.0;
+    traction.setReferencePressure(pressure);
+    traction.addScaled(scaled, scale);
+    traction.assemblePressure(direct, [&](const Range& x) { return scale*pressure(x); });
+    direct -= scaled;
+    std::cout << "addScaled against assemblePressure: " << direct.infinity_norm() << std::endl;
+    passed = passed and scaled.infinity_norm() > 0.0;
+    passed = passed and direct.infinity_norm() <= 1e-13*scaled.infinity_norm();
+  }
+
+  // Neumann load 1 on the bottom of the beam, a vertex between two faces of
+  // length h gets h/6 from each of them
+  {
+    auto mesh = "beam.msh";
+    std::vector<int> materialIndex, boundaryIndex;
+    GridFactory<Grid> factory;
+    GmshReader<Grid>::read(factory, mesh, boundaryIndex, materialIndex, true);
+    std::shared_ptr<Grid> grid(factory.createGrid());
+    auto gridView = grid->leafGridView();
+    auto basis = makeBasis(gridView, power<dim>(lagrange<p>()));
+
+    BoundaryPatch<decltype(gridView)> patch;
+    for(const auto& element : elements(gridView))
+      for(const auto& isect : intersections(gridView, element))
+        if(isect.boundary() and boundaryIndex[isect.boundarySegmentIndex()] == 0)
+          patch.add(isect);
+
+    auto one = [](const auto& index) { return 1.0; };
+    Elastodynamics::NeumannBoundaryAssembler<decltype(one)> neumann(one);
+    Elastodynamics::BoundaryAssembler<decltype(basis)> boundaryAssembler(basis, patch);
+    blockVector b(basis.size());
+    b = 0.0;
+    boundaryAssembler.assemble(neumann, b);
+
+    Elastodynamics::TractionAssembler<decltype(basis)> bottom(basis, boundaryIndex, 0);
+    BlockVector<Range> coordinates(basis.size());
+    Functions::interpolate(basis, coordinates, [](const Range& x) { return x; });
+
+    const double h = 6.0/20;
+    Range total(0.0);
+    bool shared = true;
+    for(std::size_t i=0; i<b.size(); i++)
+      total += b[i];
+    for(auto i : bottom.dofs()) {
+      const double x = coordinates[i][0];
+      const bool vertex = std::abs(x/h - std::round(x/h)) < 1e-10;
+      const bool inner = x > 1e-10 and x < 6.0-1e-10;
+      if(vertex and inner)
+        shared = shared and std::abs(b[i][0]-h/3) < 1e-12 and std::abs(b[i][1]-h/3) < 1e-12;
+    }
+    std::cout << "neumann total " << total << ", shared vertices accumulate: " << shared << std::endl;
+    passed = passed and shared;
+    passed = passed and std::abs(total[0]-6.0) < 1e-10 and std::abs(total[1]-6.0) < 1e-10;
+  }
+
+  return passed ? 0 : 1;
+
+}